@@ -30,6 +30,7 @@ typedef enum {
     ROBOMESH_ERR_TIMEOUT,
     ROBOMESH_ERR_INVALID_ARG,
     ROBOMESH_ERR_ALLOC,
+    ROBOMESH_ERR_WOULD_BLOCK,
 } robomesh_err_t;
 
 /* ── Key management ────────────────────────────────────────── */
@@ -105,8 +106,11 @@ robomesh_err_t robomesh_connect(robomesh_client_t *client);
 void robomesh_disconnect(robomesh_client_t *client);
 
 /**
- * Disconnect and reconnect to the server.
- * Does not re-authenticate — call robomesh_authenticate() after.
+ * Disconnect, reconnect, and restore the session.
+ * If a still-valid JWT is held (from a previous authenticate or an
+ * imported session), a single round-trip "RESUME <uuid> <jwt>" is tried
+ * first; on rejection or expiry the full AUTH handshake runs
+ * automatically. Returns ROBOMESH_OK with the session ready to use.
  */
 robomesh_err_t robomesh_reconnect(robomesh_client_t *client);
 
@@ -130,6 +134,91 @@ robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs);
  */
 robomesh_err_t robomesh_persist(robomesh_client_t *client);
 
+/**
+ * Upgrade the connection to binary framing via a "PROTO binary"
+ * exchange. In binary mode, messages are length-prefixed frames (4-byte
+ * big-endian length + raw payload) instead of newline-delimited text,
+ * and heartbeat signatures travel as raw 64 bytes instead of hex —
+ * halving signature bandwidth and removing newline scanning. Heartbeat
+ * channels dialed after the upgrade negotiate the same framing.
+ * If the server refuses, the connection stays line-based and
+ * ROBOMESH_ERR_AUTH is returned. Call after robomesh_connect().
+ */
+robomesh_err_t robomesh_enable_binary_framing(robomesh_client_t *client);
+
+/**
+ * Negotiate LZ4 compression for the session via a "PROTO lz4" exchange.
+ * Messages at or above threshold bytes (0 = default 512) are LZ4-
+ * compressed before framing; smaller or incompressible ones travel
+ * unchanged. The compression buffers are allocated once and reused
+ * across sends. Requires binary framing (call
+ * robomesh_enable_binary_framing() first) and an SDK built with liblz4
+ * (ROBOMESH_HAVE_LZ4); returns ROBOMESH_ERR_AUTH if the server refuses,
+ * leaving the session uncompressed.
+ */
+robomesh_err_t robomesh_enable_compression(robomesh_client_t *client,
+                                            size_t threshold);
+
+/* ── TLS ───────────────────────────────────────────────────── */
+
+/**
+ * Enable TLS for all of this client's connections. Must be called
+ * before robomesh_connect(); every socket the client dials afterwards
+ * — the main connection and the persistent heartbeat channel — is
+ * wrapped in TLS with certificate and hostname verification.
+ *
+ * The latest session ticket is cached in the client, so reconnects
+ * (including the RESUME fast path) and fresh heartbeat channels resume
+ * in a single round trip instead of a full handshake. Kernel TLS
+ * offload is enabled where OpenSSL and the kernel support it.
+ *
+ * The non-blocking auth flow and the engine's multiplexing remain
+ * cleartext-only; TLS clients use the blocking APIs.
+ *
+ * @param ca_file  PEM bundle to verify the server against, or NULL to
+ *                 use the system's default CA paths
+ */
+robomesh_err_t robomesh_enable_tls(robomesh_client_t *client,
+                                    const char *ca_file);
+
+/* ── Non-blocking AUTH/REGISTER ────────────────────────────── */
+
+/** Result of one robomesh_auth_step() call. */
+typedef enum {
+    ROBOMESH_AUTH_WANT_READ,   /* Wait for the socket to become readable */
+    ROBOMESH_AUTH_WANT_WRITE,  /* Wait for the socket to become writable */
+    ROBOMESH_AUTH_DONE,        /* Flow complete; JWT stored internally */
+    ROBOMESH_AUTH_FAILED,      /* Flow failed; see robomesh_last_error() */
+} robomesh_auth_status_t;
+
+/**
+ * Begin a non-blocking AUTH flow. Connects if needed, then drives the
+ * same challenge-response exchange as robomesh_authenticate() one
+ * readiness event at a time, so one thread can poll() the fds of many
+ * clients and authenticate them concurrently (e.g. after a server
+ * restart). Call robomesh_auth_step() whenever robomesh_get_fd() is
+ * ready in the direction the previous step requested.
+ */
+robomesh_err_t robomesh_auth_begin(robomesh_client_t *client);
+
+/**
+ * Begin a non-blocking REGISTER flow (same stepping as auth; the final
+ * step waits for admin approval, so expect WANT_READ for a long time).
+ */
+robomesh_err_t robomesh_register_begin(robomesh_client_t *client);
+
+/**
+ * Advance the active non-blocking flow as far as possible without
+ * blocking. Never sleeps; returns WANT_READ/WANT_WRITE when the socket
+ * is not ready, DONE on success, FAILED on protocol or I/O error.
+ */
+robomesh_auth_status_t robomesh_auth_step(robomesh_client_t *client);
+
+/**
+ * The client's main socket fd for poll/select integration, or -1.
+ */
+int robomesh_get_fd(const robomesh_client_t *client);
+
 /**
  * Get the JWT received from authentication. Returns NULL if not authenticated.
  */
@@ -140,10 +229,35 @@ const char *robomesh_get_jwt(const robomesh_client_t *client);
  */
 bool robomesh_is_connected(const robomesh_client_t *client);
 
+/* ── Session persistence ───────────────────────────────────── */
+
+/**
+ * Serialize the authenticated session (JWT + heartbeat sequence) into a
+ * small JSON blob suitable for flash/NVRAM. Battery-powered devices can
+ * store it before sleeping and re-import it on the next wake to skip
+ * the Ed25519 handshake while the token is still valid.
+ * Returns ROBOMESH_ERR_AUTH if not authenticated; buf should hold at
+ * least ~2.5KB to fit the JWT.
+ */
+robomesh_err_t robomesh_export_session(const robomesh_client_t *client,
+                                        char *buf, size_t buf_size);
+
+/**
+ * Restore a session exported by robomesh_export_session(). Rejects the
+ * blob (ROBOMESH_ERR_AUTH) if it is malformed, belongs to a different
+ * UUID, or its JWT is expired or within 30s of expiry. On success the
+ * JWT is available via robomesh_get_jwt() and the heartbeat sequence
+ * continues monotonically from the stored value.
+ */
+robomesh_err_t robomesh_import_session(robomesh_client_t *client,
+                                        const char *session);
+
 /* ── Heartbeat ─────────────────────────────────────────────── */
 
 /**
- * Send a heartbeat on a separate TCP connection (5s timeout).
+ * Send a heartbeat on a persistent TCP channel separate from the main
+ * connection (5s connect timeout). The channel is dialed on first use,
+ * kept alive across beats, and transparently re-dialed on failure.
  * Thread-safe: can be called from any thread.
  * @param extra_data_json  Optional extra data as JSON string, or NULL.
  *                         Must be < ~4000 bytes.
@@ -161,11 +275,72 @@ robomesh_err_t robomesh_send_heartbeat(robomesh_client_t *client,
 robomesh_err_t robomesh_start_heartbeat(robomesh_client_t *client,
                                          int interval_secs, int ttl);
 
+/**
+ * Battery-level hook for the adaptive heartbeat. Returns the charge as
+ * a percentage (0-100), or -1 if unknown.
+ */
+typedef int (*robomesh_battery_cb)(void *user_data);
+
+/**
+ * Start a background heartbeat thread that adapts its interval to link
+ * quality: every three consecutive successful beats double the interval
+ * (up to max_interval_secs), and any failed beat or reconnect snaps it
+ * back to min_interval_secs. Each beat carries a ttl of twice the
+ * current interval, so the server never sees the robot as stale even if
+ * one beat is lost. When battery_cb reports 20% or less, the interval
+ * jumps straight to the maximum to minimize radio wakeups; pass NULL to
+ * skip battery awareness. Stop with robomesh_stop_heartbeat().
+ */
+robomesh_err_t robomesh_start_heartbeat_adaptive(robomesh_client_t *client,
+                                                  int min_interval_secs,
+                                                  int max_interval_secs,
+                                                  robomesh_battery_cb battery_cb,
+                                                  void *user_data);
+
 /**
  * Stop the background heartbeat thread.
  */
 void robomesh_stop_heartbeat(robomesh_client_t *client);
 
+/* ── Shared heartbeat scheduler ────────────────────────────── */
+
+/** Opaque shared heartbeat scheduler handle. */
+typedef struct robomesh_hb_scheduler robomesh_hb_scheduler_t;
+
+/**
+ * Create a shared heartbeat scheduler: one thread that services beats
+ * for any number of registered clients, waking only when a beat is due.
+ * An opt-in alternative to robomesh_start_heartbeat() for processes
+ * driving many clients, where one thread per client (each polling its
+ * stop flag every 100ms) wastes wakeups. Fleets that also need
+ * non-blocking receive multiplexing should use the engine
+ * (robomesh_engine.h), which schedules heartbeats the same way.
+ * Returns NULL on failure.
+ */
+robomesh_hb_scheduler_t *robomesh_hb_scheduler_create(void);
+
+/**
+ * Stop the scheduler thread and free the scheduler.
+ * Registered clients are not destroyed.
+ */
+void robomesh_hb_scheduler_destroy(robomesh_hb_scheduler_t *sched);
+
+/**
+ * Register a client for scheduled heartbeats. The first beat fires
+ * immediately; later ones every interval_secs without drift. Fails if
+ * the client already runs its own heartbeat thread. Remove the client
+ * before destroying it.
+ */
+robomesh_err_t robomesh_hb_scheduler_add(robomesh_hb_scheduler_t *sched,
+                                          robomesh_client_t *client,
+                                          int interval_secs, int ttl);
+
+/**
+ * Unregister a client from the scheduler.
+ */
+robomesh_err_t robomesh_hb_scheduler_remove(robomesh_hb_scheduler_t *sched,
+                                             robomesh_client_t *client);
+
 /* ── Messaging ─────────────────────────────────────────────── */
 
 /**
@@ -184,6 +359,19 @@ robomesh_err_t robomesh_send(robomesh_client_t *client, const char *message);
 robomesh_err_t robomesh_recv(robomesh_client_t *client, char *buf, size_t buf_size,
                               int timeout_ms);
 
+/**
+ * Zero-copy receive for high-rate consumers: points *line at the next
+ * complete line inside the client's internal read buffer instead of
+ * copying it out. The view (null-terminated, *line_len bytes) is valid
+ * only until the next receive call on this client. Lines longer than
+ * the internal buffer (4KB) cannot be viewed and return
+ * ROBOMESH_ERR_RECV — fall back to robomesh_recv() for those. In binary
+ * framing mode, one frame is read into the buffer and viewed the same
+ * way. Do not mix with the background receive thread.
+ */
+robomesh_err_t robomesh_recv_view(robomesh_client_t *client, const char **line,
+                                   size_t *line_len, int timeout_ms);
+
 /** Callback type for incoming messages. */
 typedef void (*robomesh_message_cb)(const char *message, void *user_data);
 
@@ -200,6 +388,63 @@ robomesh_err_t robomesh_start_recv(robomesh_client_t *client,
  */
 void robomesh_stop_recv(robomesh_client_t *client);
 
+/**
+ * Start the background receive thread in queued mode: instead of
+ * invoking a callback inline on the network thread (where a slow
+ * callback stalls socket draining), messages are pushed into a bounded
+ * lock-free ring (256 slots, 4KB each) and the application drains them
+ * with robomesh_poll_messages() on its own thread. When the ring is
+ * full — or a message exceeds the slot size — the message is dropped
+ * and counted in robomesh_stats_t.recv_overflows.
+ */
+robomesh_err_t robomesh_start_recv_queued(robomesh_client_t *client);
+
+/**
+ * Drain queued messages, invoking the callback for each on the calling
+ * thread. Pass max_messages <= 0 to drain everything available.
+ * Single consumer: call from one thread only. Returns the number
+ * delivered, or -1 if the client is not in queued mode. May still be
+ * called after robomesh_stop_recv() to drain the remainder.
+ */
+int robomesh_poll_messages(robomesh_client_t *client,
+                            robomesh_message_cb callback, void *user_data,
+                            int max_messages);
+
+/* ── Statistics ────────────────────────────────────────────── */
+
+/** Number of latency histogram buckets in robomesh_stats_t. */
+#define ROBOMESH_STATS_BUCKETS 16
+
+/**
+ * Point-in-time snapshot of a client's performance counters.
+ *
+ * Latency histograms use fixed power-of-two buckets: bucket i counts
+ * samples below (32 << i) microseconds — 32µs, 64µs, … ~1s — and the
+ * last bucket collects everything slower. Counters are maintained with
+ * relaxed atomics, so reading them adds no lock contention; a snapshot
+ * taken while other threads are active may be torn across fields but
+ * each individual counter is consistent.
+ */
+typedef struct {
+    uint64_t messages_sent;       /* Successful robomesh_send() calls */
+    uint64_t messages_received;   /* Lines/frames delivered to the app */
+    uint64_t bytes_sent;          /* Payload bytes of successful sends */
+    uint64_t bytes_received;      /* Payload bytes of received messages */
+    uint64_t heartbeats_sent;     /* Heartbeats acknowledged by the server */
+    uint64_t heartbeat_failures;  /* Heartbeats that failed or were rejected */
+    uint64_t reconnects;          /* Re-dials (main and heartbeat channel) */
+    uint64_t auth_failures;       /* Failed AUTH/REGISTER attempts */
+    uint64_t recv_overflows;      /* Messages dropped by the queued recv ring */
+    uint64_t heartbeat_rtt[ROBOMESH_STATS_BUCKETS];  /* Beat → ack round-trip */
+    uint64_t send_latency[ROBOMESH_STATS_BUCKETS];   /* robomesh_send() duration */
+} robomesh_stats_t;
+
+/**
+ * Copy the client's current counters into *stats.
+ */
+robomesh_err_t robomesh_get_stats(const robomesh_client_t *client,
+                                   robomesh_stats_t *stats);
+
 /* ── Utility ───────────────────────────────────────────────── */
 
 /**
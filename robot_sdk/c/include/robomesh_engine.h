@@ -0,0 +1,88 @@
+/**
+ * Robomesh Robot SDK - multi-client event engine.
+ *
+ * Multiplexes the sockets, heartbeat timers, and receive callbacks of
+ * many robomesh_client_t instances on a single event-loop thread, for
+ * gateways and fleet simulators where one or two threads per client
+ * does not scale. The blocking per-client API (robomesh_start_heartbeat,
+ * robomesh_start_recv) remains available for single-robot firmware;
+ * a client must use one mode or the other, never both.
+ *
+ * Uses epoll on Linux and poll elsewhere.
+ */
+
+#ifndef ROBOMESH_ENGINE_H
+#define ROBOMESH_ENGINE_H
+
+#include "robomesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Opaque engine handle. */
+typedef struct robomesh_engine robomesh_engine_t;
+
+/**
+ * Callback for lines received on a registered client's main socket.
+ * Invoked on the engine thread. A NULL message means the client's
+ * connection was lost and it has been removed from the engine.
+ * Must not call robomesh_engine_add/remove (would deadlock).
+ */
+typedef void (*robomesh_engine_message_cb)(robomesh_client_t *client,
+                                            const char *message,
+                                            void *user_data);
+
+/**
+ * Create an engine. Must be freed with robomesh_engine_destroy().
+ */
+robomesh_engine_t *robomesh_engine_create(void);
+
+/**
+ * Destroy the engine. Stops the loop and unregisters all clients.
+ * Registered clients are not destroyed — the caller still owns them.
+ */
+void robomesh_engine_destroy(robomesh_engine_t *engine);
+
+/**
+ * Register a connected (and typically authenticated) client.
+ * The engine watches the client's main socket and delivers complete
+ * lines to callback. If hb_interval_secs > 0 the engine also sends a
+ * signed heartbeat every interval on the client's persistent heartbeat
+ * channel, without a dedicated thread.
+ * The client must not have its own heartbeat/receive threads running.
+ */
+robomesh_err_t robomesh_engine_add(robomesh_engine_t *engine,
+                                    robomesh_client_t *client,
+                                    int hb_interval_secs, int hb_ttl,
+                                    robomesh_engine_message_cb callback,
+                                    void *user_data);
+
+/**
+ * Unregister a client. Safe to call from any thread except an engine
+ * callback. The client's sockets are left open.
+ */
+robomesh_err_t robomesh_engine_remove(robomesh_engine_t *engine,
+                                       robomesh_client_t *client);
+
+/**
+ * Start the engine's event-loop thread.
+ */
+robomesh_err_t robomesh_engine_start(robomesh_engine_t *engine);
+
+/**
+ * Stop the event-loop thread. Clients stay registered and the engine
+ * can be started again.
+ */
+void robomesh_engine_stop(robomesh_engine_t *engine);
+
+/**
+ * Number of currently registered clients.
+ */
+size_t robomesh_engine_count(robomesh_engine_t *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ROBOMESH_ENGINE_H */
@@ -0,0 +1,116 @@
+/**
+ * Robomesh Robot SDK - Gateway multiplexing for edge bridges.
+ *
+ * One authenticated carrier connection carries traffic for many robot
+ * UUIDs: per-message channel tags, per-UUID Ed25519 signing (the
+ * gateway holds each robot's keypair), and batched heartbeats for every
+ * child in a single exchange. Collapses a bridge's connection count
+ * from one socket per robot to one socket per gateway.
+ */
+
+#ifndef ROBOMESH_GATEWAY_H
+#define ROBOMESH_GATEWAY_H
+
+#include "robomesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ── Gateway ──────────────────────────────────────────────── */
+
+/** Opaque gateway handle. */
+typedef struct robomesh_gateway robomesh_gateway_t;
+
+/** Callback for messages addressed to an attached child UUID. */
+typedef void (*robomesh_gateway_message_cb)(const char *uuid,
+                                             const char *message,
+                                             void *user_data);
+
+/**
+ * Upgrade an authenticated carrier client into a gateway via a
+ * "GATEWAY" exchange. The carrier must be connected and authenticated;
+ * the gateway layers entirely on the client's send/recv paths, so
+ * binary framing, compression, and TLS on the carrier all apply to
+ * multiplexed traffic. Returns NULL if the server refuses the upgrade
+ * or on allocation failure. The carrier stays owned by the caller and
+ * must outlive the gateway; don't mix direct robomesh_recv() calls on
+ * it with gateway use.
+ */
+robomesh_gateway_t *robomesh_gateway_create(robomesh_client_t *carrier);
+
+/**
+ * Destroy the gateway and zero all child key material. Does not
+ * disconnect the carrier.
+ */
+void robomesh_gateway_destroy(robomesh_gateway_t *gw);
+
+/**
+ * Attach a child robot to the carrier. The server issues a nonce that
+ * is signed with the child's own keypair — the same challenge-response
+ * as a direct AUTH, so a gateway can only speak for robots whose keys
+ * it actually holds. The keypair is copied; the caller's copy may be
+ * discarded.
+ */
+robomesh_err_t robomesh_gateway_attach(robomesh_gateway_t *gw,
+                                        const char *uuid,
+                                        const robomesh_keypair_t *keypair);
+
+/**
+ * Detach a child. Its key material is zeroed.
+ */
+robomesh_err_t robomesh_gateway_detach(robomesh_gateway_t *gw,
+                                        const char *uuid);
+
+/** Number of currently attached children. */
+size_t robomesh_gateway_count(const robomesh_gateway_t *gw);
+
+/* ── Messaging ────────────────────────────────────────────── */
+
+/**
+ * Send a message on behalf of an attached child. The payload travels
+ * with the child's channel tag; the server routes it to the child's
+ * handler as if it had arrived on a dedicated connection.
+ */
+robomesh_err_t robomesh_gateway_send(robomesh_gateway_t *gw,
+                                      const char *uuid, const char *message);
+
+/**
+ * Register a callback for messages the server addresses to attached
+ * children. Runs on the thread that calls robomesh_gateway_poll() (or
+ * whichever gateway call happens to read the message while waiting for
+ * its own response).
+ */
+void robomesh_gateway_on_message(robomesh_gateway_t *gw,
+                                  robomesh_gateway_message_cb callback,
+                                  void *user_data);
+
+/**
+ * Read and dispatch one incoming message. Returns ROBOMESH_OK after
+ * dispatching, ROBOMESH_ERR_TIMEOUT if nothing arrived in time.
+ */
+robomesh_err_t robomesh_gateway_poll(robomesh_gateway_t *gw, int timeout_ms);
+
+/* ── Heartbeat ────────────────────────────────────────────── */
+
+/**
+ * Send one batched heartbeat covering every attached child. Each
+ * child's payload carries its own monotonic sequence number and is
+ * signed with its own key, but all of them travel in a single exchange
+ * — one round trip for the whole fleet behind the gateway instead of
+ * one per robot. The assembly buffer is reused across calls.
+ * @param ttl  Custom TTL in seconds applied to every child, or 0 for
+ *             the server default
+ */
+robomesh_err_t robomesh_gateway_heartbeat_all(robomesh_gateway_t *gw, int ttl);
+
+/**
+ * Get the last error message.
+ */
+const char *robomesh_gateway_last_error(const robomesh_gateway_t *gw);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ROBOMESH_GATEWAY_H */
@@ -0,0 +1,77 @@
+/**
+ * Robomesh Robot SDK - Memory-mapped fleet key store.
+ *
+ * A binary file of raw Ed25519 seeds and precomputed public keys,
+ * sorted by UUID. Opening is one mmap; lookups are a binary search and
+ * two memcpys — no hex parsing and no OpenSSL key derivation, so a
+ * fleet simulator loading thousands of keypairs starts in milliseconds
+ * instead of tens of seconds.
+ *
+ * The file holds unencrypted private seeds: keep it readable only by
+ * the fleet process (the builder creates it mode 0600).
+ */
+
+#ifndef ROBOMESH_KEYSTORE_H
+#define ROBOMESH_KEYSTORE_H
+
+#include "robomesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ── Key store ────────────────────────────────────────────── */
+
+/** Opaque read-only key store handle. */
+typedef struct robomesh_keystore robomesh_keystore_t;
+
+/**
+ * Map a key store file. Validates the magic, version, and size; the
+ * records stay in the mapping, nothing is copied. Returns NULL on I/O
+ * error or a malformed file. Safe for concurrent readers.
+ */
+robomesh_keystore_t *robomesh_keystore_open(const char *path);
+
+/**
+ * Unmap and free the store. Keypairs previously copied out remain valid.
+ */
+void robomesh_keystore_close(robomesh_keystore_t *ks);
+
+/**
+ * Look up a UUID by binary search and copy its keypair out.
+ * Returns ROBOMESH_ERR_INVALID_ARG if the UUID is not in the store.
+ */
+robomesh_err_t robomesh_keystore_get(const robomesh_keystore_t *ks,
+                                      const char *uuid,
+                                      robomesh_keypair_t *kp);
+
+/** Number of records in the store. */
+size_t robomesh_keystore_count(const robomesh_keystore_t *ks);
+
+/**
+ * Copy the record at index (0-based, UUID-sorted) — the iteration path
+ * for simulators that want every key without knowing the UUIDs.
+ * uuid_out must hold at least 64 bytes; pass NULL to skip either output.
+ */
+robomesh_err_t robomesh_keystore_get_at(const robomesh_keystore_t *ks,
+                                         size_t index, char *uuid_out,
+                                         robomesh_keypair_t *kp);
+
+/* ── Building ─────────────────────────────────────────────── */
+
+/**
+ * Write a key store file from parallel arrays of UUIDs and keypairs.
+ * Records are sorted by UUID before writing so lookups can binary
+ * search; UUIDs longer than 63 bytes are rejected. The file is created
+ * mode 0600 and fully replaces any existing store at path.
+ */
+robomesh_err_t robomesh_keystore_build(const char *path,
+                                        const char *const *uuids,
+                                        const robomesh_keypair_t *keypairs,
+                                        size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ROBOMESH_KEYSTORE_H */
@@ -40,6 +40,23 @@ robomesh_mqtt_client_t *robomesh_mqtt_create(const robomesh_mqtt_config_t *confi
  */
 void robomesh_mqtt_destroy(robomesh_mqtt_client_t *client);
 
+/**
+ * Enable persistent-session mode. Must be called before
+ * robomesh_mqtt_connect(). The broker session is reconfigured with
+ * clean_session=false under the client's stable id, so subscriptions
+ * and undelivered messages survive broker reconnects, and message
+ * publishes switch to QoS 1 with a pipelined in-flight window
+ * (max_inflight unacked publishes at once, 0 = default 20) instead of
+ * stop-and-wait. While the broker is unreachable, sends are parked in
+ * an offline FIFO bounded by offline_queue_bytes (oldest entries are
+ * dropped when full; 0 disables queueing) and replayed in order on
+ * reconnect. Intended for cellular-connected robots that drop broker
+ * connections frequently.
+ */
+robomesh_err_t robomesh_mqtt_enable_persistent(robomesh_mqtt_client_t *client,
+                                                int max_inflight,
+                                                size_t offline_queue_bytes);
+
 /**
  * Connect to the MQTT broker and start the network loop.
  */
@@ -67,6 +84,17 @@ robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int ti
  */
 const char *robomesh_mqtt_get_jwt(const robomesh_mqtt_client_t *client);
 
+/**
+ * Serialize the authenticated session (JWT + heartbeat sequence) for
+ * flash/NVRAM storage, and restore it on the next wake to skip the
+ * handshake. Same blob format and validation as the TCP client —
+ * see robomesh_export_session() in robomesh.h.
+ */
+robomesh_err_t robomesh_mqtt_export_session(const robomesh_mqtt_client_t *client,
+                                             char *buf, size_t buf_size);
+robomesh_err_t robomesh_mqtt_import_session(robomesh_mqtt_client_t *client,
+                                             const char *session);
+
 /* ── Heartbeat ────────────────────────────────────────────── */
 
 /**
@@ -98,6 +126,18 @@ void robomesh_mqtt_stop_heartbeat(robomesh_mqtt_client_t *client);
  */
 robomesh_err_t robomesh_mqtt_send(robomesh_mqtt_client_t *client, const char *message);
 
+/**
+ * Enable LZ4 compression for this session. Messages at or above
+ * threshold bytes (0 = default 512) are compressed before publishing;
+ * smaller or incompressible ones travel unchanged. Compressed payloads
+ * carry a 5-byte header (0x01 magic + original length) that the server
+ * detects per message — MQTT has no upgrade handshake, so make sure the
+ * server side understands the header before enabling. Buffers are
+ * allocated once and reused; requires an SDK built with liblz4.
+ */
+robomesh_err_t robomesh_mqtt_enable_compression(robomesh_mqtt_client_t *client,
+                                                 size_t threshold);
+
 /**
  * Register a callback for incoming messages from the handler.
  * Messages arrive on robomesh/to_robot/{uuid}.
@@ -106,11 +146,45 @@ void robomesh_mqtt_on_message(robomesh_mqtt_client_t *client,
                                robomesh_mqtt_message_cb callback,
                                void *user_data);
 
+/* ── Async publish ────────────────────────────────────────── */
+
+/**
+ * Start the async publish thread. robomesh_mqtt_send_async() then
+ * enqueues into a bounded ring drained by that thread, so a slow
+ * broker never stalls the caller. Stopped automatically on disconnect
+ * (remaining queued messages are drained first).
+ */
+robomesh_err_t robomesh_mqtt_start_async(robomesh_mqtt_client_t *client);
+
+/**
+ * Stop the async publish thread after draining the queue.
+ */
+void robomesh_mqtt_stop_async(robomesh_mqtt_client_t *client);
+
+/**
+ * Queue a message for asynchronous publishing. Never blocks: returns
+ * ROBOMESH_ERR_WOULD_BLOCK when the ring is full (128 messages) —
+ * the caller decides whether to drop, coalesce, or retry.
+ * Messages are capped at 1KB; larger ones go through robomesh_mqtt_send().
+ * Single producer: call from one thread only.
+ */
+robomesh_err_t robomesh_mqtt_send_async(robomesh_mqtt_client_t *client,
+                                         const char *message);
+
 /**
  * Get the last error message.
  */
 const char *robomesh_mqtt_last_error(const robomesh_mqtt_client_t *client);
 
+/**
+ * Copy the client's performance counters into *stats.
+ * Heartbeat RTT covers publish → broker response; send latency only
+ * covers the publish call (QoS 0 has no acknowledgement).
+ * See robomesh_stats_t in robomesh.h.
+ */
+robomesh_err_t robomesh_mqtt_get_stats(const robomesh_mqtt_client_t *client,
+                                        robomesh_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
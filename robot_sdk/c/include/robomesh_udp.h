@@ -58,6 +58,17 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client);
  */
 const char *robomesh_udp_get_jwt(const robomesh_udp_client_t *client);
 
+/**
+ * Serialize the authenticated session (JWT + heartbeat sequence) for
+ * flash/NVRAM storage, and restore it on the next wake to skip the
+ * handshake. Same blob format and validation as the TCP client —
+ * see robomesh_export_session() in robomesh.h.
+ */
+robomesh_err_t robomesh_udp_export_session(const robomesh_udp_client_t *client,
+                                            char *buf, size_t buf_size);
+robomesh_err_t robomesh_udp_import_session(robomesh_udp_client_t *client,
+                                            const char *session);
+
 /* ── Heartbeat ────────────────────────────────────────────── */
 
 /**
@@ -97,11 +108,107 @@ robomesh_err_t robomesh_udp_recv(robomesh_udp_client_t *client,
                                   char *buf, size_t buf_size,
                                   int timeout_ms);
 
+/* ── Batched I/O ──────────────────────────────────────────── */
+
+/*
+ * Gateway-oriented batching: queued packets are flushed in a single
+ * sendmmsg() syscall on Linux (sendto loop elsewhere), and
+ * robomesh_udp_recv_batch() delivers many datagrams per recvmmsg().
+ * Queued sends are fire-and-forget — responses arrive via
+ * robomesh_udp_recv() or robomesh_udp_recv_batch(), not inline.
+ */
+
+/** One slot in a receive batch. buf/buf_size are caller-provided;
+    len is filled in with the datagram size (buf is null-terminated). */
+typedef struct {
+    char *buf;
+    size_t buf_size;
+    size_t len;
+} robomesh_udp_packet_t;
+
+/**
+ * Build, sign, and queue a heartbeat without waiting for the server's
+ * response. The queue holds 64 packets and auto-flushes when full.
+ */
+robomesh_err_t robomesh_udp_queue_heartbeat(robomesh_udp_client_t *client,
+                                             const char *extra_data_json,
+                                             int ttl);
+
+/**
+ * Queue a JWT-authenticated message without waiting for the response.
+ * Queued packets are capped at 2KB; send larger ones via robomesh_udp_send().
+ */
+robomesh_err_t robomesh_udp_queue_message(robomesh_udp_client_t *client,
+                                           const char *message);
+
+/**
+ * Send all queued packets in one batch.
+ */
+robomesh_err_t robomesh_udp_flush(robomesh_udp_client_t *client);
+
+/**
+ * Receive up to count datagrams in one syscall.
+ * Blocks up to timeout_ms for the first datagram; the rest are taken
+ * only if already pending. Returns the number received (0 on timeout),
+ * or -1 on error.
+ */
+int robomesh_udp_recv_batch(robomesh_udp_client_t *client,
+                             robomesh_udp_packet_t *packets, int count,
+                             int timeout_ms);
+
+/* ── Reliable messaging ───────────────────────────────────── */
+
+/*
+ * Optional reliability for the message path on lossy links; heartbeats
+ * stay fire-and-forget. Reliable messages carry a "msg_seq" number and
+ * sit in a 32-slot sliding window of preallocated buffers (no
+ * per-packet allocation) until the server acknowledges them with a
+ * cumulative "ack" field — accepted on any server packet, including
+ * heartbeat responses, so a steady heartbeat doubles as the ack
+ * channel. Unacked packets retransmit with exponential backoff (250ms
+ * doubling up to 4s) whenever robomesh_udp_reliable_poll() runs.
+ * Requires server-side ack support; against an older server the window
+ * fills and sends return ROBOMESH_ERR_WOULD_BLOCK.
+ */
+
+/**
+ * Enable reliability mode on this client.
+ */
+robomesh_err_t robomesh_udp_enable_reliability(robomesh_udp_client_t *client);
+
+/**
+ * Send a message through the reliability window. Returns immediately;
+ * delivery is retried until acknowledged. ROBOMESH_ERR_WOULD_BLOCK
+ * means the window is full — poll and retry. Packets are capped at 2KB.
+ */
+robomesh_err_t robomesh_udp_send_reliable(robomesh_udp_client_t *client,
+                                           const char *message);
+
+/**
+ * Retransmit packets whose timeout expired. Call periodically (e.g.
+ * every 100ms) from the control loop. Returns the number retransmitted,
+ * or -1 if reliability is not enabled.
+ */
+int robomesh_udp_reliable_poll(robomesh_udp_client_t *client);
+
+/**
+ * Number of sent-but-unacknowledged packets in the window, or -1.
+ */
+int robomesh_udp_reliable_pending(robomesh_udp_client_t *client);
+
 /**
  * Get the last error message.
  */
 const char *robomesh_udp_last_error(const robomesh_udp_client_t *client);
 
+/**
+ * Copy the client's performance counters into *stats.
+ * Send latency covers the full acknowledged round-trip (UDP sends
+ * wait for the server's ack). See robomesh_stats_t in robomesh.h.
+ */
+robomesh_err_t robomesh_udp_get_stats(const robomesh_udp_client_t *client,
+                                       robomesh_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "robomesh.h"
+#include "robomesh_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,6 +17,7 @@
 #include <time.h>
 #include <pthread.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -23,6 +25,12 @@
 
 #include <openssl/evp.h>
 #include <openssl/rand.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#ifdef ROBOMESH_HAVE_LZ4
+#include <lz4.h>
+#endif
 
 #define MAX_LINE 65536
 #define JWT_MAX 2048
@@ -30,6 +38,8 @@
 #define READ_BUF_SIZE 4096
 #define MAX_REGISTER_TIMEOUT 300
 #define HEARTBEAT_CONNECT_TIMEOUT 5
+#define RECV_RING_SLOTS 256       /* power of two — indexes are masked */
+#define RECV_RING_SLOT_SIZE 4096
 
 /* ── Internal structures ──────────────────────────────────── */
 
@@ -39,6 +49,7 @@ struct robomesh_client {
     int tcp_port;
     char device_type[64];
     robomesh_keypair_t keypair;
+    robomesh_signer_t signer;
     int sock;
     bool connected;
     char jwt[JWT_MAX];
@@ -47,11 +58,52 @@ struct robomesh_client {
 
     pthread_mutex_t mutex;
 
+    /* Performance counters (relaxed atomics; see robomesh_get_stats) */
+    robomesh_stats_atomic_t stats;
+
+    /* Binary framing (negotiated via "PROTO binary") */
+    bool binary_framing;      /* main socket */
+    bool hb_binary;           /* heartbeat channel; guarded by hb_sock_mutex */
+
+    /* Optional LZ4 compression (negotiated via "PROTO lz4"; requires
+       binary framing). Separate send/recv buffers so the receive thread
+       never races the sender; both are allocated once on enable and
+       reused across messages. */
+    bool compression;
+    size_t comp_threshold;
+    char *comp_buf;           /* send-side scratch */
+    char *comp_rbuf;          /* recv-side staging */
+    size_t comp_buf_size;
+
+    /* Optional TLS (enabled before connect; wraps the main socket and
+       the heartbeat channel). The latest session ticket is cached in the
+       client so reconnects and fresh heartbeat channels resume in one
+       round trip instead of a full handshake. */
+    bool tls;
+    SSL_CTX *ssl_ctx;
+    SSL *ssl;                 /* main socket */
+    SSL *hb_ssl;              /* heartbeat channel; guarded by hb_sock_mutex */
+    SSL_SESSION *tls_session; /* latest ticket; guarded by mutex */
+
+    /* Persistent heartbeat channel (separate from the main socket) */
+    int hb_sock;
+    pthread_mutex_t hb_sock_mutex;
+
     /* Buffered read state for main socket */
     char rbuf[READ_BUF_SIZE];
     size_t rbuf_pos;
     size_t rbuf_len;
 
+    /* Preserialized heartbeat pieces: the line prefix never changes and
+       the payload suffix only changes when the ttl does, so steady-state
+       beats are assembled with memcpys instead of snprintf chains. */
+    char hb_prefix[300];          /* "HEARTBEAT <uuid> " */
+    size_t hb_prefix_len;
+    char hb_tpl_suffix[32];       /* ",\"ttl\":N}" or "}"; guarded by mutex */
+    size_t hb_tpl_suffix_len;
+    int hb_tpl_ttl;
+    bool hb_tpl_valid;
+
     /* Background heartbeat thread */
     pthread_t hb_thread;
     volatile bool hb_running;
@@ -59,33 +111,40 @@ struct robomesh_client {
     int hb_interval;
     int hb_ttl;
 
+    /* Adaptive heartbeat state (only touched by the heartbeat thread
+       once started). The interval widens after a streak of successful
+       beats and snaps back to the minimum on failure or reconnect. */
+    bool hb_adaptive;
+    int hb_min_interval;
+    int hb_max_interval;
+    int hb_streak;
+    uint64_t hb_last_reconnects;
+    robomesh_battery_cb battery_cb;
+    void *battery_cb_data;
+
+    /* Non-blocking AUTH/REGISTER state machine */
+    int auth_flow;
+    int auth_phase;
+    char auth_out[512];
+    size_t auth_out_len;
+    size_t auth_out_pos;
+    char auth_line[JWT_MAX + 64];
+    size_t auth_line_pos;
+
     /* Background receive thread */
     pthread_t recv_thread_handle;
     volatile bool recv_running;
     bool recv_started;
     robomesh_message_cb recv_cb;
     void *recv_cb_data;
-};
-
-/* ── Hex utilities ────────────────────────────────────────── */
-
-static void bytes_to_hex(const uint8_t *bytes, size_t len, char *hex) {
-    for (size_t i = 0; i < len; i++) {
-        sprintf(hex + i * 2, "%02x", bytes[i]);
-    }
-    hex[len * 2] = '\0';
-}
 
-static int hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_len) {
-    size_t hex_len = strlen(hex);
-    if (hex_len % 2 != 0 || hex_len / 2 > max_len) return -1;
-    for (size_t i = 0; i < hex_len / 2; i++) {
-        unsigned int val;
-        if (sscanf(hex + i * 2, "%2x", &val) != 1) return -1;
-        bytes[i] = (uint8_t)val;
-    }
-    return (int)(hex_len / 2);
-}
+    /* Queued delivery: SPSC ring between the receive thread (producer)
+       and robomesh_poll_messages() (consumer). Allocated lazily by
+       robomesh_start_recv_queued(); NULL in callback mode. */
+    char (*recv_ring)[RECV_RING_SLOT_SIZE];
+    _Atomic uint32_t recv_ring_head;   /* consumer position */
+    _Atomic uint32_t recv_ring_tail;   /* producer position */
+};
 
 /* ── Validation ──────────────────────────────────────────── */
 
@@ -101,29 +160,6 @@ static bool is_valid_device_type(const char *dt) {
     return true;
 }
 
-/* ── Ed25519 operations ───────────────────────────────────── */
-
-static robomesh_err_t ed25519_sign(const robomesh_keypair_t *kp,
-                                     const uint8_t *msg, size_t msg_len,
-                                     uint8_t *sig, size_t *sig_len) {
-    EVP_PKEY *pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
-                                                    kp->private_key, 32);
-    if (!pkey) return ROBOMESH_ERR_CRYPTO;
-
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) { EVP_PKEY_free(pkey); return ROBOMESH_ERR_CRYPTO; }
-
-    robomesh_err_t err = ROBOMESH_OK;
-    if (EVP_DigestSignInit(ctx, NULL, NULL, NULL, pkey) != 1 ||
-        EVP_DigestSign(ctx, sig, sig_len, msg, msg_len) != 1) {
-        err = ROBOMESH_ERR_CRYPTO;
-    }
-
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(pkey);
-    return err;
-}
-
 /* ── Key management ───────────────────────────────────────── */
 
 robomesh_err_t robomesh_generate_keypair(robomesh_keypair_t *kp) {
@@ -159,7 +195,7 @@ robomesh_err_t robomesh_load_keypair(const char *private_key_hex, robomesh_keypa
 
     memset(kp, 0, sizeof(*kp));
 
-    if (hex_to_bytes(private_key_hex, kp->private_key, 32) != 32) {
+    if (robomesh_hex_decode(private_key_hex, kp->private_key, 32) != 32) {
         memset(kp, 0, sizeof(*kp));
         return ROBOMESH_ERR_INVALID_ARG;
     }
@@ -184,11 +220,11 @@ robomesh_err_t robomesh_load_keypair(const char *private_key_hex, robomesh_keypa
 }
 
 void robomesh_public_key_hex(const robomesh_keypair_t *kp, char *out) {
-    bytes_to_hex(kp->public_key, 32, out);
+    robomesh_hex_encode(kp->public_key, 32, out);
 }
 
 void robomesh_private_key_hex(const robomesh_keypair_t *kp, char *out) {
-    bytes_to_hex(kp->private_key, 32, out);
+    robomesh_hex_encode(kp->private_key, 32, out);
 }
 
 /* ── TCP helpers ──────────────────────────────────────────── */
@@ -225,55 +261,293 @@ static int tcp_connect(const char *host, int port) {
     return tcp_connect_with_timeout(host, port, 30);
 }
 
-static int send_line(int sock, const char *line) {
-    size_t len = strlen(line);
-    char *buf = malloc(len + 2);
-    if (!buf) return -1;
-    memcpy(buf, line, len);
-    buf[len] = '\n';
-    buf[len + 1] = '\0';
-
-    ssize_t total = 0;
-    while ((size_t)total < len + 1) {
-        ssize_t n = send(sock, buf + total, len + 1 - total, 0);
-        if (n <= 0) { free(buf); return -1; }
-        total += n;
-    }
-    free(buf);
+/* ── TLS ──────────────────────────────────────────────────── */
+
+/*
+ * Transport helpers below take the socket plus an optional SSL handle;
+ * with TLS enabled the same code paths run through SSL_read/SSL_write
+ * (or kTLS underneath, when OpenSSL and the kernel take over). Handles
+ * are created by tls_handshake() against the client's shared SSL_CTX.
+ */
+
+static int tls_write_all(SSL *ssl, const void *buf, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+        int n = SSL_write(ssl, (const char *)buf + pos, (int)(len - pos));
+        if (n <= 0) return -1;
+        pos += (size_t)n;
+    }
+    return 0;
+}
+
+/* TLS 1.3 delivers session tickets after the handshake, so sessions are
+   captured here rather than with SSL_get1_session() at connect time.
+   Returning 1 keeps the reference; the previous ticket is released. */
+static int tls_new_session_cb(SSL *ssl, SSL_SESSION *sess) {
+    robomesh_client_t *c = SSL_get_app_data(ssl);
+    if (!c) return 0;
+    pthread_mutex_lock(&c->mutex);
+    if (c->tls_session)
+        SSL_SESSION_free(c->tls_session);
+    c->tls_session = sess;
+    pthread_mutex_unlock(&c->mutex);
+    return 1;
+}
+
+/* Run the TLS handshake on a freshly connected socket, offering the
+   cached session ticket for one-round-trip resumption. Returns 0 and
+   the new handle on success, -1 on failure (socket untouched). */
+static int tls_handshake(robomesh_client_t *c, int sock, SSL **out) {
+    SSL *ssl = SSL_new(c->ssl_ctx);
+    if (!ssl) return -1;
+    SSL_set_fd(ssl, sock);
+    SSL_set_app_data(ssl, c);
+    SSL_set_tlsext_host_name(ssl, c->host);
+    SSL_set1_host(ssl, c->host);
+
+    pthread_mutex_lock(&c->mutex);
+    if (c->tls_session)
+        SSL_set_session(ssl, c->tls_session);
+    pthread_mutex_unlock(&c->mutex);
+
+    if (SSL_connect(ssl) != 1) {
+        SSL_free(ssl);
+        return -1;
+    }
+    *out = ssl;
+    return 0;
+}
+
+/* Scatter-gather send of the line plus a trailing newline. Avoids the
+   per-message heap copy the old append-'\n' path paid. */
+static int send_line(int sock, SSL *ssl, const char *line) {
+    if (ssl) {
+        if (tls_write_all(ssl, line, strlen(line)) < 0) return -1;
+        return tls_write_all(ssl, "\n", 1);
+    }
+    static const char newline = '\n';
+    struct iovec iov[2] = {
+        { .iov_base = (void *)line,    .iov_len = strlen(line) },
+        { .iov_base = (void *)&newline, .iov_len = 1 },
+    };
+
+    int idx = 0;
+    while (idx < 2) {
+        ssize_t n = writev(sock, &iov[idx], 2 - idx);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        /* Advance past fully and partially written iovecs */
+        size_t left = (size_t)n;
+        while (idx < 2 && left >= iov[idx].iov_len) {
+            left -= iov[idx].iov_len;
+            idx++;
+        }
+        if (idx < 2) {
+            iov[idx].iov_base = (char *)iov[idx].iov_base + left;
+            iov[idx].iov_len -= left;
+        }
+    }
     return 0;
 }
 
-/* Byte-at-a-time recv for temporary sockets (heartbeat responses) */
-static int recv_line_raw(int sock, char *buf, size_t buf_size) {
+/* Line recv for sockets without buffered read state (heartbeat channel).
+   Peeks a block, finds the newline with memchr, then consumes exactly up
+   to and including it — instead of the old one-syscall-per-byte loop.
+   SSL_peek mirrors MSG_PEEK on TLS channels. */
+static int recv_line_raw(int sock, SSL *ssl, char *buf, size_t buf_size) {
     size_t pos = 0;
     while (pos < buf_size - 1) {
-        char c;
-        ssize_t n = recv(sock, &c, 1, 0);
+        ssize_t n = ssl ? (ssize_t)SSL_peek(ssl, buf + pos,
+                                            (int)(buf_size - 1 - pos))
+                        : recv(sock, buf + pos, buf_size - 1 - pos, MSG_PEEK);
         if (n <= 0) return -1;
-        if (c == '\n') break;
-        buf[pos++] = c;
+
+        char *nl = memchr(buf + pos, '\n', (size_t)n);
+        size_t take = nl ? (size_t)(nl - (buf + pos)) + 1 : (size_t)n;
+
+        ssize_t m = ssl ? (ssize_t)SSL_read(ssl, buf + pos, (int)take)
+                        : recv(sock, buf + pos, take, 0);
+        if (m <= 0) return -1;
+        pos += (size_t)m;
+
+        if (nl && m == (ssize_t)take) {
+            buf[pos - 1] = '\0';
+            return (int)(pos - 1);
+        }
+    }
+    buf[buf_size - 1] = '\0';
+    return (int)(buf_size - 1);
+}
+
+/* ── Binary framing ───────────────────────────────────────── */
+
+/*
+ * Optional length-prefixed framing negotiated with "PROTO binary" after
+ * connect. A frame is a 4-byte big-endian payload length followed by the
+ * raw payload — no newline scanning, no hex doubling for signatures.
+ */
+
+/* Send one frame: header + payload + optional raw tail (e.g. signature). */
+static int frame_send(int sock, SSL *ssl, const void *payload, size_t len,
+                       const void *tail, size_t tail_len) {
+    uint8_t hdr[4];
+    size_t total = len + tail_len;
+    hdr[0] = (uint8_t)(total >> 24);
+    hdr[1] = (uint8_t)(total >> 16);
+    hdr[2] = (uint8_t)(total >> 8);
+    hdr[3] = (uint8_t)total;
+
+    if (ssl) {
+        if (tls_write_all(ssl, hdr, sizeof(hdr)) < 0) return -1;
+        if (tls_write_all(ssl, payload, len) < 0) return -1;
+        if (tail_len > 0 && tls_write_all(ssl, tail, tail_len) < 0) return -1;
+        return 0;
     }
-    buf[pos] = '\0';
-    return (int)pos;
+
+    struct iovec iov[3] = {
+        { .iov_base = hdr,             .iov_len = sizeof(hdr) },
+        { .iov_base = (void *)payload, .iov_len = len },
+        { .iov_base = (void *)tail,    .iov_len = tail_len },
+    };
+    int iovcnt = tail_len > 0 ? 3 : 2;
+
+    int idx = 0;
+    while (idx < iovcnt) {
+        ssize_t n = writev(sock, &iov[idx], iovcnt - idx);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        size_t left = (size_t)n;
+        while (idx < iovcnt && left >= iov[idx].iov_len) {
+            left -= iov[idx].iov_len;
+            idx++;
+        }
+        if (idx < iovcnt) {
+            iov[idx].iov_base = (char *)iov[idx].iov_base + left;
+            iov[idx].iov_len -= left;
+        }
+    }
+    return 0;
+}
+
+static int recv_all(int sock, SSL *ssl, void *buf, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+        ssize_t n = ssl ? (ssize_t)SSL_read(ssl, (char *)buf + pos,
+                                            (int)(len - pos))
+                        : recv(sock, (char *)buf + pos, len - pos, 0);
+        if (n <= 0) {
+            if (!ssl && n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        pos += (size_t)n;
+    }
+    return 0;
+}
+
+/* Receive one frame into buf (null-terminated). Returns the payload
+   length, or -1 on I/O error or a frame larger than the buffer. */
+static int frame_recv(int sock, SSL *ssl, char *buf, size_t buf_size) {
+    uint8_t hdr[4];
+    if (recv_all(sock, ssl, hdr, sizeof(hdr)) < 0) return -1;
+    size_t len = ((size_t)hdr[0] << 24) | ((size_t)hdr[1] << 16) |
+                 ((size_t)hdr[2] << 8) | (size_t)hdr[3];
+    if (len > buf_size - 1) return -1;
+    if (recv_all(sock, ssl, buf, len) < 0) return -1;
+    buf[len] = '\0';
+    return (int)len;
+}
+
+/* Negotiate binary framing on an already-connected socket. Returns 0 if
+   the server accepted, -1 if it refused (connection stays line-based),
+   -2 on I/O error. */
+static int negotiate_binary(int sock, SSL *ssl, char *resp, size_t resp_size) {
+    if (send_line(sock, ssl, "PROTO binary") < 0) return -2;
+    if (recv_line_raw(sock, ssl, resp, resp_size) < 0) return -2;
+    return (strcmp(resp, "PROTO_OK") == 0) ? 0 : -1;
 }
 
-/* Buffered recv for the client's main socket */
+/* Compressed frames carry a 5-byte header: 0x01 magic plus the
+   big-endian original length, followed by the LZ4 block. 0x01 never
+   starts an uncompressed JSON/text frame, so the receiver can tell the
+   two apart without negotiating per message. */
+
+static int frame_send_maybe_compressed(robomesh_client_t *c,
+                                        const char *msg, size_t len) {
+#ifdef ROBOMESH_HAVE_LZ4
+    if (c->compression && len >= c->comp_threshold) {
+        int clen = LZ4_compress_default(msg, c->comp_buf + 5, (int)len,
+                                        (int)(c->comp_buf_size - 5));
+        if (clen > 0 && (size_t)clen + 5 < len) {
+            c->comp_buf[0] = 0x01;
+            c->comp_buf[1] = (char)((len >> 24) & 0xFF);
+            c->comp_buf[2] = (char)((len >> 16) & 0xFF);
+            c->comp_buf[3] = (char)((len >> 8) & 0xFF);
+            c->comp_buf[4] = (char)(len & 0xFF);
+            return frame_send(c->sock, c->ssl, c->comp_buf, (size_t)clen + 5,
+                              NULL, 0);
+        }
+        /* Incompressible payloads go out as-is */
+    }
+#endif
+    return frame_send(c->sock, c->ssl, msg, len, NULL, 0);
+}
+
+static int frame_recv_maybe_compressed(robomesh_client_t *c,
+                                        char *buf, size_t buf_size) {
+#ifdef ROBOMESH_HAVE_LZ4
+    if (c->compression) {
+        int r = frame_recv(c->sock, c->ssl, c->comp_rbuf, c->comp_buf_size);
+        if (r < 0) return -1;
+        if (r >= 5 && (uint8_t)c->comp_rbuf[0] == 0x01) {
+            size_t orig = ((size_t)(uint8_t)c->comp_rbuf[1] << 24) |
+                          ((size_t)(uint8_t)c->comp_rbuf[2] << 16) |
+                          ((size_t)(uint8_t)c->comp_rbuf[3] << 8) |
+                          (size_t)(uint8_t)c->comp_rbuf[4];
+            if (orig > buf_size - 1) return -1;
+            int d = LZ4_decompress_safe(c->comp_rbuf + 5, buf, r - 5, (int)orig);
+            if (d < 0 || (size_t)d != orig) return -1;
+            buf[orig] = '\0';
+            return (int)orig;
+        }
+        if ((size_t)r > buf_size - 1) return -1;
+        memcpy(buf, c->comp_rbuf, (size_t)r + 1);
+        return r;
+    }
+#endif
+    return frame_recv(c->sock, c->ssl, buf, buf_size);
+}
+
+/* Buffered recv for the client's main socket. Scans for the newline
+   with memchr and copies whole chunks instead of byte-at-a-time. */
 static int recv_line_buffered(robomesh_client_t *c, char *buf, size_t buf_size) {
     size_t out_pos = 0;
-    while (out_pos < buf_size - 1) {
-        /* Drain existing buffer data */
-        while (c->rbuf_pos < c->rbuf_len && out_pos < buf_size - 1) {
-            char ch = c->rbuf[c->rbuf_pos++];
-            if (ch == '\n') {
+    for (;;) {
+        if (c->rbuf_pos < c->rbuf_len) {
+            size_t avail = c->rbuf_len - c->rbuf_pos;
+            char *nl = memchr(c->rbuf + c->rbuf_pos, '\n', avail);
+            size_t chunk = nl ? (size_t)(nl - (c->rbuf + c->rbuf_pos)) : avail;
+            size_t space = buf_size - 1 - out_pos;
+            size_t copy = chunk < space ? chunk : space;
+
+            memcpy(buf + out_pos, c->rbuf + c->rbuf_pos, copy);
+            out_pos += copy;
+            c->rbuf_pos += copy;
+
+            if (nl && copy == chunk) {
+                c->rbuf_pos++;  /* consume the newline */
                 buf[out_pos] = '\0';
                 return (int)out_pos;
             }
-            buf[out_pos++] = ch;
+            if (out_pos >= buf_size - 1) break;
         }
-        if (out_pos >= buf_size - 1) break;
 
         /* Refill buffer from socket */
-        ssize_t n = recv(c->sock, c->rbuf, READ_BUF_SIZE, 0);
+        ssize_t n = c->ssl ? (ssize_t)SSL_read(c->ssl, c->rbuf, READ_BUF_SIZE)
+                           : recv(c->sock, c->rbuf, READ_BUF_SIZE, 0);
         if (n <= 0) return -1;
         c->rbuf_pos = 0;
         c->rbuf_len = (size_t)n;
@@ -282,6 +556,73 @@ static int recv_line_buffered(robomesh_client_t *c, char *buf, size_t buf_size)
     return (int)out_pos;
 }
 
+/* ── Heartbeat channel ────────────────────────────────────── */
+
+/* Close the persistent heartbeat socket. Caller holds hb_sock_mutex. */
+static void heartbeat_channel_close_locked(robomesh_client_t *c) {
+    if (c->hb_ssl) {
+        SSL_free(c->hb_ssl);
+        c->hb_ssl = NULL;
+    }
+    if (c->hb_sock >= 0) {
+        close(c->hb_sock);
+        c->hb_sock = -1;
+    }
+}
+
+/* Ensure the persistent heartbeat socket is open, negotiating binary
+   framing on it when the client has upgraded. Caller holds hb_sock_mutex.
+   Returns 0 on success, -1 on connect failure. */
+static int heartbeat_channel_ensure_locked(robomesh_client_t *c) {
+    if (c->hb_sock >= 0) return 0;
+    c->hb_sock = tcp_connect_with_timeout(c->host, c->tcp_port,
+                                           HEARTBEAT_CONNECT_TIMEOUT);
+    if (c->hb_sock < 0) return -1;
+
+    /* TLS channels resume from the cached session ticket, so re-dialing
+       the heartbeat socket costs one round trip, not a full handshake */
+    if (c->tls && tls_handshake(c, c->hb_sock, &c->hb_ssl) < 0) {
+        close(c->hb_sock);
+        c->hb_sock = -1;
+        return -1;
+    }
+
+    c->hb_binary = false;
+    if (c->binary_framing) {
+        char resp[64];
+        int r = negotiate_binary(c->hb_sock, c->hb_ssl, resp, sizeof(resp));
+        if (r == -2) {
+            heartbeat_channel_close_locked(c);
+            return -1;
+        }
+        /* On refusal the channel simply stays line-based */
+        c->hb_binary = (r == 0);
+    }
+    return 0;
+}
+
+/* One heartbeat exchange on the channel, in whichever framing it speaks:
+   line mode sends the prebuilt hex-signature line, binary mode sends a
+   frame of the text prefix plus the raw 64-byte signature. Caller holds
+   hb_sock_mutex. Returns 0 on success, -1 on I/O failure (socket closed). */
+static int heartbeat_channel_exchange_locked(robomesh_client_t *c,
+                                              const char *line,
+                                              const char *bin_text,
+                                              const uint8_t *sig, size_t sig_len,
+                                              char *resp, size_t resp_size) {
+    int ok;
+    if (c->hb_binary) {
+        ok = (frame_send(c->hb_sock, c->hb_ssl, bin_text, strlen(bin_text),
+                         sig, sig_len) == 0 &&
+              frame_recv(c->hb_sock, c->hb_ssl, resp, resp_size) >= 0) ? 0 : -1;
+    } else {
+        ok = (send_line(c->hb_sock, c->hb_ssl, line) == 0 &&
+              recv_line_raw(c->hb_sock, c->hb_ssl, resp, resp_size) >= 0) ? 0 : -1;
+    }
+    if (ok < 0) heartbeat_channel_close_locked(c);
+    return ok;
+}
+
 /* ── Client lifecycle ─────────────────────────────────────── */
 
 static void set_error(robomesh_client_t *c, const char *fmt, ...) {
@@ -294,6 +635,10 @@ static void set_error(robomesh_client_t *c, const char *fmt, ...) {
 static void mark_disconnected(robomesh_client_t *c) {
     pthread_mutex_lock(&c->mutex);
     c->connected = false;
+    if (c->ssl) {
+        SSL_free(c->ssl);
+        c->ssl = NULL;
+    }
     if (c->sock >= 0) {
         shutdown(c->sock, SHUT_RDWR);
         close(c->sock);
@@ -301,6 +646,8 @@ static void mark_disconnected(robomesh_client_t *c) {
     }
     c->rbuf_pos = 0;
     c->rbuf_len = 0;
+    c->binary_framing = false;
+    c->compression = false;
     pthread_mutex_unlock(&c->mutex);
 }
 
@@ -318,18 +665,36 @@ robomesh_client_t *robomesh_client_create(const robomesh_config_t *config) {
     if (config->device_type)
         strncpy(c->device_type, config->device_type, sizeof(c->device_type) - 1);
     memcpy(&c->keypair, config->keypair, sizeof(robomesh_keypair_t));
+    if (robomesh_signer_init(&c->signer, &c->keypair) != ROBOMESH_OK) {
+        memset(&c->keypair, 0, sizeof(robomesh_keypair_t));
+        free(c);
+        return NULL;
+    }
     c->sock = -1;
+    c->hb_sock = -1;
     c->connected = false;
     c->heartbeat_seq = (int64_t)time(NULL);
+    c->hb_prefix_len = (size_t)snprintf(c->hb_prefix, sizeof(c->hb_prefix),
+                                         "HEARTBEAT %s ", c->uuid);
     pthread_mutex_init(&c->mutex, NULL);
+    pthread_mutex_init(&c->hb_sock_mutex, NULL);
     return c;
 }
 
 void robomesh_client_destroy(robomesh_client_t *client) {
     if (!client) return;
     robomesh_disconnect(client);
+    if (client->tls_session)
+        SSL_SESSION_free(client->tls_session);
+    if (client->ssl_ctx)
+        SSL_CTX_free(client->ssl_ctx);
+    free(client->recv_ring);
+    free(client->comp_buf);
+    free(client->comp_rbuf);
     pthread_mutex_destroy(&client->mutex);
+    pthread_mutex_destroy(&client->hb_sock_mutex);
     /* Zero out key material */
+    robomesh_signer_free(&client->signer);
     memset(&client->keypair, 0, sizeof(robomesh_keypair_t));
     free(client);
 }
@@ -343,6 +708,14 @@ robomesh_err_t robomesh_connect(robomesh_client_t *client) {
         set_error(client, "Failed to connect to %s:%d", client->host, client->tcp_port);
         return ROBOMESH_ERR_CONNECT;
     }
+    if (client->tls && tls_handshake(client, client->sock, &client->ssl) < 0) {
+        const char *reason = ERR_reason_error_string(ERR_get_error());
+        set_error(client, "TLS handshake failed: %s",
+                  reason ? reason : "unknown error");
+        close(client->sock);
+        client->sock = -1;
+        return ROBOMESH_ERR_CONNECT;
+    }
     client->connected = true;
     client->rbuf_pos = 0;
     client->rbuf_len = 0;
@@ -359,6 +732,11 @@ void robomesh_disconnect(robomesh_client_t *client) {
     /* Close socket (unblocks any blocking recv in threads) */
     mark_disconnected(client);
 
+    /* Close the persistent heartbeat channel */
+    pthread_mutex_lock(&client->hb_sock_mutex);
+    heartbeat_channel_close_locked(client);
+    pthread_mutex_unlock(&client->hb_sock_mutex);
+
     /* Join threads after socket is closed */
     if (client->hb_started) {
         pthread_join(client->hb_thread, NULL);
@@ -370,10 +748,51 @@ void robomesh_disconnect(robomesh_client_t *client) {
     }
 }
 
+/* Attempt single round-trip session resumption with the stored JWT.
+   Returns 0 on success, -1 if the server rejected it (connection still
+   usable for a full AUTH), -2 on I/O error. */
+static int try_resume(robomesh_client_t *client) {
+    char line[JWT_MAX + 300];
+    snprintf(line, sizeof(line), "RESUME %s %s", client->uuid, client->jwt);
+    if (send_line(client->sock, client->ssl, line) < 0) return -2;
+
+    char buf[MAX_LINE];
+    if (recv_line_buffered(client, buf, sizeof(buf)) < 0) return -2;
+    return strcmp(buf, "RESUME_OK") == 0 ? 0 : -1;
+}
+
 robomesh_err_t robomesh_reconnect(robomesh_client_t *client) {
     if (!client) return ROBOMESH_ERR_INVALID_ARG;
     robomesh_disconnect(client);
-    return robomesh_connect(client);
+    robomesh_stats_add(&client->stats.reconnects, 1);
+
+    robomesh_err_t err = robomesh_connect(client);
+    if (err != ROBOMESH_OK) return err;
+
+    /* Fast path: restore the session in one round trip with the JWT
+       from the previous connection, skipping the 4-round-trip nonce
+       exchange. Falls back to a full AUTH if the token has expired or
+       the server rejects it. */
+    if (client->jwt[0] != '\0' &&
+        robomesh_jwt_expiry(client->jwt) > (int64_t)time(NULL) + 30) {
+        int r = try_resume(client);
+        if (r == 0) return ROBOMESH_OK;
+        if (r == -2) {
+            /* The connection died mid-exchange — re-dial before the
+               full handshake */
+            robomesh_disconnect(client);
+            err = robomesh_connect(client);
+            if (err != ROBOMESH_OK) return err;
+        }
+    }
+    return robomesh_authenticate(client);
+}
+
+robomesh_err_t robomesh_get_stats(const robomesh_client_t *client,
+                                   robomesh_stats_t *stats) {
+    if (!client || !stats) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_stats_snapshot(&client->stats, stats);
+    return ROBOMESH_OK;
 }
 
 bool robomesh_is_connected(const robomesh_client_t *client) {
@@ -390,11 +809,47 @@ const char *robomesh_last_error(const robomesh_client_t *client) {
     return client->last_error;
 }
 
-/* ── AUTH flow ────────────────────────────────────────────── */
+/* ── Session persistence ──────────────────────────────────── */
 
-robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
-    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+robomesh_err_t robomesh_export_session(const robomesh_client_t *client,
+                                        char *buf, size_t buf_size) {
+    if (!client || !buf) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->jwt[0] == '\0') return ROBOMESH_ERR_AUTH;
+    if (robomesh_session_pack(client->uuid, client->jwt,
+                              client->heartbeat_seq, buf, buf_size) < 0)
+        return ROBOMESH_ERR_INVALID_ARG;
+    return ROBOMESH_OK;
+}
 
+robomesh_err_t robomesh_import_session(robomesh_client_t *client,
+                                        const char *session) {
+    if (!client || !session) return ROBOMESH_ERR_INVALID_ARG;
+
+    char jwt[JWT_MAX];
+    int64_t seq;
+    int r = robomesh_session_unpack(session, client->uuid, jwt, sizeof(jwt), &seq);
+    if (r == -2) {
+        set_error(client, "Stored session expired");
+        return ROBOMESH_ERR_AUTH;
+    }
+    if (r < 0) {
+        set_error(client, "Invalid session blob");
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    pthread_mutex_lock(&client->mutex);
+    strncpy(client->jwt, jwt, JWT_MAX - 1);
+    /* Keep the sequence monotonic: the stored value wins only if it is
+       ahead of the time-seeded default */
+    if (seq > client->heartbeat_seq)
+        client->heartbeat_seq = seq;
+    pthread_mutex_unlock(&client->mutex);
+    return ROBOMESH_OK;
+}
+
+/* ── AUTH flow ────────────────────────────────────────────── */
+
+static robomesh_err_t do_authenticate(robomesh_client_t *client) {
     robomesh_err_t err;
     if (!client->connected) {
         err = robomesh_connect(client);
@@ -404,7 +859,7 @@ robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
     char buf[MAX_LINE];
 
     /* Step 1: Send AUTH */
-    if (send_line(client->sock, "AUTH") < 0) {
+    if (send_line(client->sock, client->ssl, "AUTH") < 0) {
         set_error(client, "Failed to send AUTH");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -422,7 +877,7 @@ robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
     }
 
     /* Step 3: Send UUID */
-    if (send_line(client->sock, client->uuid) < 0) {
+    if (send_line(client->sock, client->ssl, client->uuid) < 0) {
         set_error(client, "Failed to send UUID");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -442,7 +897,7 @@ robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
     /* Step 5: Sign the nonce */
     const char *nonce_hex = buf + 6;
     uint8_t nonce_bytes[256];
-    int nonce_len = hex_to_bytes(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
+    int nonce_len = robomesh_hex_decode(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
     if (nonce_len < 0) {
         set_error(client, "Invalid nonce hex");
         return ROBOMESH_ERR_AUTH;
@@ -450,17 +905,17 @@ robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
 
     uint8_t sig[64];
     size_t sig_len = sizeof(sig);
-    err = ed25519_sign(&client->keypair, nonce_bytes, nonce_len, sig, &sig_len);
+    err = robomesh_signer_sign(&client->signer, nonce_bytes, nonce_len, sig, &sig_len);
     if (err != ROBOMESH_OK) {
         set_error(client, "Failed to sign nonce");
         return err;
     }
 
     char sig_hex[129];
-    bytes_to_hex(sig, sig_len, sig_hex);
+    robomesh_hex_encode(sig, sig_len, sig_hex);
 
     /* Step 6: Send signature */
-    if (send_line(client->sock, sig_hex) < 0) {
+    if (send_line(client->sock, client->ssl, sig_hex) < 0) {
         set_error(client, "Failed to send signature");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -481,6 +936,14 @@ robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
     return ROBOMESH_OK;
 }
 
+robomesh_err_t robomesh_authenticate(robomesh_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_err_t err = do_authenticate(client);
+    if (err != ROBOMESH_OK)
+        robomesh_stats_add(&client->stats.auth_failures, 1);
+    return err;
+}
+
 /* ── REGISTER flow ────────────────────────────────────────── */
 
 robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs) {
@@ -505,7 +968,7 @@ robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs) {
 
     char buf[MAX_LINE];
 
-    if (send_line(client->sock, "REGISTER") < 0) {
+    if (send_line(client->sock, client->ssl, "REGISTER") < 0) {
         set_error(client, "Failed to send REGISTER");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -517,7 +980,7 @@ robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs) {
         return ROBOMESH_ERR_AUTH;
     }
 
-    if (send_line(client->sock, client->uuid) < 0) {
+    if (send_line(client->sock, client->ssl, client->uuid) < 0) {
         set_error(client, "Failed to send UUID");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -529,7 +992,7 @@ robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs) {
         return ROBOMESH_ERR_AUTH;
     }
 
-    if (send_line(client->sock, client->device_type) < 0) {
+    if (send_line(client->sock, client->ssl, client->device_type) < 0) {
         set_error(client, "Failed to send device_type");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -543,7 +1006,7 @@ robomesh_err_t robomesh_register(robomesh_client_t *client, int timeout_secs) {
 
     char pub_hex[65];
     robomesh_public_key_hex(&client->keypair, pub_hex);
-    if (send_line(client->sock, pub_hex) < 0) {
+    if (send_line(client->sock, client->ssl, pub_hex) < 0) {
         set_error(client, "Failed to send public key");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -587,7 +1050,7 @@ robomesh_err_t robomesh_persist(robomesh_client_t *client) {
     if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
 
     char buf[MAX_LINE];
-    if (send_line(client->sock, "PERSIST") < 0) {
+    if (send_line(client->sock, client->ssl, "PERSIST") < 0) {
         set_error(client, "Failed to send PERSIST");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
@@ -604,82 +1067,536 @@ robomesh_err_t robomesh_persist(robomesh_client_t *client) {
     return ROBOMESH_OK;
 }
 
-/* ── Heartbeat ────────────────────────────────────────────── */
+/* ── Framing upgrade ──────────────────────────────────────── */
 
-robomesh_err_t robomesh_send_heartbeat(robomesh_client_t *client,
-                                         const char *extra_data_json,
-                                         int ttl) {
+robomesh_err_t robomesh_enable_binary_framing(robomesh_client_t *client) {
+    if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->binary_framing) return ROBOMESH_OK;
+
+    if (send_line(client->sock, client->ssl, "PROTO binary") < 0) {
+        set_error(client, "Failed to send PROTO upgrade");
+        mark_disconnected(client);
+        return ROBOMESH_ERR_SEND;
+    }
+    char buf[256];
+    if (recv_line_buffered(client, buf, sizeof(buf)) < 0) {
+        set_error(client, "Failed to receive PROTO response");
+        mark_disconnected(client);
+        return ROBOMESH_ERR_RECV;
+    }
+    if (strcmp(buf, "PROTO_OK") != 0) {
+        set_error(client, "Server refused binary framing: %s", buf);
+        return ROBOMESH_ERR_AUTH;
+    }
+    client->binary_framing = true;
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_enable_compression(robomesh_client_t *client,
+                                            size_t threshold) {
+#ifndef ROBOMESH_HAVE_LZ4
+    (void)threshold;
+    if (client) set_error(client, "SDK built without LZ4 support");
+    return ROBOMESH_ERR_INVALID_ARG;
+#else
+    if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->compression) return ROBOMESH_OK;
+    if (!client->binary_framing) {
+        set_error(client, "Compression requires binary framing");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    if (!client->comp_buf) {
+        client->comp_buf_size = (size_t)LZ4_compressBound(MAX_LINE) + 5;
+        client->comp_buf = malloc(client->comp_buf_size);
+        client->comp_rbuf = malloc(client->comp_buf_size);
+        if (!client->comp_buf || !client->comp_rbuf) {
+            free(client->comp_buf);
+            free(client->comp_rbuf);
+            client->comp_buf = NULL;
+            client->comp_rbuf = NULL;
+            set_error(client, "Failed to allocate compression buffers");
+            return ROBOMESH_ERR_ALLOC;
+        }
+    }
+
+    if (frame_send(client->sock, client->ssl, "PROTO lz4", 9, NULL, 0) < 0) {
+        set_error(client, "Failed to send PROTO upgrade");
+        mark_disconnected(client);
+        return ROBOMESH_ERR_SEND;
+    }
+    char buf[256];
+    if (frame_recv(client->sock, client->ssl, buf, sizeof(buf)) < 0) {
+        set_error(client, "Failed to receive PROTO response");
+        mark_disconnected(client);
+        return ROBOMESH_ERR_RECV;
+    }
+    if (strcmp(buf, "PROTO_OK") != 0) {
+        set_error(client, "Server refused compression: %s", buf);
+        return ROBOMESH_ERR_AUTH;
+    }
+    client->comp_threshold = threshold > 0 ? threshold : 512;
+    client->compression = true;
+    return ROBOMESH_OK;
+#endif
+}
+
+robomesh_err_t robomesh_enable_tls(robomesh_client_t *client,
+                                    const char *ca_file) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->connected) {
+        set_error(client, "TLS must be enabled before connecting");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    if (client->tls) return ROBOMESH_OK;
+
+    SSL_CTX *ctx = SSL_CTX_new(TLS_client_method());
+    if (!ctx) {
+        set_error(client, "Failed to create TLS context");
+        return ROBOMESH_ERR_CRYPTO;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, NULL);
+    if (ca_file) {
+        if (SSL_CTX_load_verify_locations(ctx, ca_file, NULL) != 1) {
+            SSL_CTX_free(ctx);
+            set_error(client, "Failed to load CA file: %s", ca_file);
+            return ROBOMESH_ERR_CRYPTO;
+        }
+    } else {
+        SSL_CTX_set_default_verify_paths(ctx);
+    }
+
+    /* Client-side session cache: tickets land in tls_new_session_cb, so
+       every connection after the first — reconnects and heartbeat
+       channels alike — resumes in a single round trip */
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT |
+                                        SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, tls_new_session_cb);
+
+#ifdef SSL_OP_ENABLE_KTLS
+    /* Kernel TLS offload where OpenSSL and the kernel support it —
+       steady-state sends skip the user-space record copy. Silently a
+       no-op on unsupported cipher/kernel combinations. */
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
+    client->ssl_ctx = ctx;
+    client->tls = true;
+    return ROBOMESH_OK;
+}
+
+/* ── Non-blocking AUTH/REGISTER ───────────────────────────── */
+
+enum { AUTH_FLOW_NONE = 0, AUTH_FLOW_AUTH, AUTH_FLOW_REGISTER };
+
+/* Queue an outgoing line (plus newline) for the state machine to flush.
+   Auth-flow lines are short: command words, the UUID, and hex strings. */
+static void auth_queue_line(robomesh_client_t *c, const char *line) {
+    size_t len = strlen(line);
+    if (len > sizeof(c->auth_out) - 1) len = sizeof(c->auth_out) - 1;
+    memcpy(c->auth_out, line, len);
+    c->auth_out[len] = '\n';
+    c->auth_out_len = len + 1;
+    c->auth_out_pos = 0;
+}
+
+static robomesh_err_t auth_flow_begin(robomesh_client_t *client, int flow,
+                                       const char *first_line) {
+    robomesh_err_t err;
+    if (client->tls) {
+        /* The step functions rely on MSG_DONTWAIT, which doesn't exist
+           for SSL records — TLS clients use the blocking flows. */
+        set_error(client, "Non-blocking auth is not supported over TLS; "
+                          "use robomesh_authenticate()");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    if (!client->connected) {
+        err = robomesh_connect(client);
+        if (err != ROBOMESH_OK) return err;
+    }
+    client->auth_flow = flow;
+    client->auth_phase = 0;
+    client->auth_line_pos = 0;
+    auth_queue_line(client, first_line);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_auth_begin(robomesh_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    return auth_flow_begin(client, AUTH_FLOW_AUTH, "AUTH");
+}
+
+robomesh_err_t robomesh_register_begin(robomesh_client_t *client) {
     if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->device_type[0] == '\0') {
+        set_error(client, "device_type required for registration");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    if (!is_valid_device_type(client->device_type)) {
+        set_error(client, "Invalid device_type: must match [a-zA-Z0-9_-]{1,64}");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    return auth_flow_begin(client, AUTH_FLOW_REGISTER, "REGISTER");
+}
 
-    /* Atomically increment sequence number */
+static robomesh_auth_status_t auth_flow_fail(robomesh_client_t *c) {
+    c->auth_flow = AUTH_FLOW_NONE;
+    robomesh_stats_add(&c->stats.auth_failures, 1);
+    return ROBOMESH_AUTH_FAILED;
+}
+
+/* Sign the "NONCE <hex>" line and queue the hex signature. */
+static int auth_sign_nonce(robomesh_client_t *c, const char *line) {
+    if (strncmp(line, "NONCE ", 6) != 0) {
+        set_error(c, "Expected NONCE, got: %s", line);
+        return -1;
+    }
+    uint8_t nonce_bytes[256];
+    int nonce_len = robomesh_hex_decode(line + 6, nonce_bytes, sizeof(nonce_bytes));
+    if (nonce_len < 0) {
+        set_error(c, "Invalid nonce hex");
+        return -1;
+    }
+    uint8_t sig[64];
+    size_t sig_len = sizeof(sig);
+    if (robomesh_signer_sign(&c->signer, nonce_bytes, nonce_len, sig, &sig_len)
+            != ROBOMESH_OK) {
+        set_error(c, "Failed to sign nonce");
+        return -1;
+    }
+    char sig_hex[129];
+    robomesh_hex_encode(sig, sig_len, sig_hex);
+    auth_queue_line(c, sig_hex);
+    return 0;
+}
+
+robomesh_auth_status_t robomesh_auth_step(robomesh_client_t *client) {
+    if (!client || client->auth_flow == AUTH_FLOW_NONE)
+        return ROBOMESH_AUTH_FAILED;
+
+    for (;;) {
+        /* Flush any queued outgoing line without blocking */
+        while (client->auth_out_pos < client->auth_out_len) {
+            ssize_t n = send(client->sock, client->auth_out + client->auth_out_pos,
+                             client->auth_out_len - client->auth_out_pos,
+                             MSG_DONTWAIT);
+            if (n > 0) {
+                client->auth_out_pos += (size_t)n;
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return ROBOMESH_AUTH_WANT_WRITE;
+            if (n < 0 && errno == EINTR) continue;
+            set_error(client, "Send failed during auth");
+            mark_disconnected(client);
+            return auth_flow_fail(client);
+        }
+
+        /* Read the next server line without blocking */
+        int r = robomesh_client_try_recv_line(client, client->auth_line,
+                                               sizeof(client->auth_line),
+                                               &client->auth_line_pos);
+        if (r == 0) return ROBOMESH_AUTH_WANT_READ;
+        if (r < 0) {
+            set_error(client, "Connection lost during auth");
+            mark_disconnected(client);
+            return auth_flow_fail(client);
+        }
+
+        const char *line = client->auth_line;
+        if (client->auth_flow == AUTH_FLOW_AUTH) {
+            switch (client->auth_phase) {
+            case 0:
+                if (strcmp(line, "AUTH_CHALLENGE") != 0) {
+                    set_error(client, "Expected AUTH_CHALLENGE, got: %s", line);
+                    return auth_flow_fail(client);
+                }
+                auth_queue_line(client, client->uuid);
+                client->auth_phase = 1;
+                break;
+            case 1:
+                if (auth_sign_nonce(client, line) < 0)
+                    return auth_flow_fail(client);
+                client->auth_phase = 2;
+                break;
+            case 2:
+                if (strncmp(line, "AUTH_OK ", 8) != 0) {
+                    set_error(client, "Auth failed: %s", line);
+                    return auth_flow_fail(client);
+                }
+                strncpy(client->jwt, line + 8, JWT_MAX - 1);
+                client->auth_flow = AUTH_FLOW_NONE;
+                return ROBOMESH_AUTH_DONE;
+            }
+        } else {
+            switch (client->auth_phase) {
+            case 0:
+                if (strcmp(line, "REGISTER_CHALLENGE") != 0) {
+                    set_error(client, "Expected REGISTER_CHALLENGE, got: %s", line);
+                    return auth_flow_fail(client);
+                }
+                auth_queue_line(client, client->uuid);
+                client->auth_phase = 1;
+                break;
+            case 1:
+                if (strcmp(line, "SEND_DEVICE_TYPE") != 0) {
+                    set_error(client, "Expected SEND_DEVICE_TYPE, got: %s", line);
+                    return auth_flow_fail(client);
+                }
+                auth_queue_line(client, client->device_type);
+                client->auth_phase = 2;
+                break;
+            case 2: {
+                if (strcmp(line, "SEND_PUBLIC_KEY") != 0) {
+                    set_error(client, "Expected SEND_PUBLIC_KEY, got: %s", line);
+                    return auth_flow_fail(client);
+                }
+                char pub_hex[65];
+                robomesh_public_key_hex(&client->keypair, pub_hex);
+                auth_queue_line(client, pub_hex);
+                client->auth_phase = 3;
+                break;
+            }
+            case 3:
+                if (strcmp(line, "REGISTER_PENDING") != 0) {
+                    set_error(client, "Expected REGISTER_PENDING, got: %s", line);
+                    return auth_flow_fail(client);
+                }
+                /* Now waiting for admin approval — nothing queued */
+                client->auth_phase = 4;
+                break;
+            case 4:
+                if (strncmp(line, "REGISTER_OK ", 12) == 0) {
+                    strncpy(client->jwt, line + 12, JWT_MAX - 1);
+                    client->auth_flow = AUTH_FLOW_NONE;
+                    return ROBOMESH_AUTH_DONE;
+                }
+                if (strcmp(line, "REGISTER_REJECTED") == 0)
+                    set_error(client, "Registration rejected");
+                else
+                    set_error(client, "Unexpected response: %s", line);
+                return auth_flow_fail(client);
+            }
+        }
+    }
+}
+
+int robomesh_get_fd(const robomesh_client_t *client) {
+    if (!client) return -1;
+    return client->sock;
+}
+
+/* ── Heartbeat ────────────────────────────────────────────── */
+
+/* Minimal decimal formatter — heartbeat seqs are never negative and
+   this skips a printf round-trip on every beat. Returns digit count. */
+static size_t u64_to_dec(uint64_t v, char *out) {
+    char tmp[20];
+    size_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (size_t i = 0; i < n; i++)
+        out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+/* Build and sign the heartbeat payload JSON.
+ *
+ * The common case (no extra_data, same ttl as the last beat — i.e. every
+ * beat from the background thread or engine) only formats the sequence
+ * number: the surrounding JSON skeleton is preserialized once into
+ * hb_tpl_suffix and reused until the ttl changes. */
+static robomesh_err_t build_heartbeat_parts(robomesh_client_t *client,
+                                             const char *extra_data_json, int ttl,
+                                             char *payload, size_t payload_size,
+                                             uint8_t *sig, size_t *sig_len) {
+    char suffix[sizeof(client->hb_tpl_suffix)];
+    size_t suffix_len = 0;
+
+    /* Atomically increment sequence number; refresh the preserialized
+       suffix under the same lock if the ttl changed since the last beat */
     pthread_mutex_lock(&client->mutex);
     client->heartbeat_seq++;
     int64_t seq = client->heartbeat_seq;
+    if (!extra_data_json) {
+        if (!client->hb_tpl_valid || client->hb_tpl_ttl != ttl) {
+            if (ttl > 0) {
+                client->hb_tpl_suffix_len = (size_t)snprintf(
+                    client->hb_tpl_suffix, sizeof(client->hb_tpl_suffix),
+                    ",\"ttl\":%d}", ttl);
+            } else {
+                client->hb_tpl_suffix[0] = '}';
+                client->hb_tpl_suffix[1] = '\0';
+                client->hb_tpl_suffix_len = 1;
+            }
+            client->hb_tpl_ttl = ttl;
+            client->hb_tpl_valid = true;
+        }
+        suffix_len = client->hb_tpl_suffix_len;
+        memcpy(suffix, client->hb_tpl_suffix, suffix_len);
+    }
     pthread_mutex_unlock(&client->mutex);
 
-    /* Build payload JSON */
-    char payload[4096];
-    int off = snprintf(payload, sizeof(payload), "{\"seq\":%lld", (long long)seq);
-    if (ttl > 0)
-        off += snprintf(payload + off, sizeof(payload) - off, ",\"ttl\":%d", ttl);
-    if (extra_data_json)
-        off += snprintf(payload + off, sizeof(payload) - off, ",\"extra_data\":%s", extra_data_json);
-    int tail = snprintf(payload + off, sizeof(payload) - off, "}");
-    if (off + tail >= (int)sizeof(payload)) {
-        set_error(client, "Heartbeat payload too large (truncated at %zu bytes)", sizeof(payload));
-        return ROBOMESH_ERR_INVALID_ARG;
+    size_t len;
+    if (!extra_data_json) {
+        /* Fast path: memcpy the template around the formatted seq.
+           Worst case is 7 + 20 digits + 31 suffix bytes, well under any
+           caller's buffer */
+        memcpy(payload, "{\"seq\":", 7);
+        len = 7 + u64_to_dec((uint64_t)seq, payload + 7);
+        memcpy(payload + len, suffix, suffix_len);
+        len += suffix_len;
+        payload[len] = '\0';
+    } else {
+        int off = snprintf(payload, payload_size, "{\"seq\":%lld", (long long)seq);
+        if (ttl > 0)
+            off += snprintf(payload + off, payload_size - off, ",\"ttl\":%d", ttl);
+        off += snprintf(payload + off, payload_size - off, ",\"extra_data\":%s", extra_data_json);
+        int tail = snprintf(payload + off, payload_size - off, "}");
+        if (off + tail >= (int)payload_size) {
+            set_error(client, "Heartbeat payload too large (truncated at %zu bytes)", payload_size);
+            return ROBOMESH_ERR_INVALID_ARG;
+        }
+        len = (size_t)(off + tail);
     }
 
     /* Sign the raw JSON bytes */
-    uint8_t sig[64];
-    size_t sig_len = sizeof(sig);
-    robomesh_err_t err = ed25519_sign(&client->keypair,
-                                        (const uint8_t *)payload, strlen(payload),
-                                        sig, &sig_len);
+    robomesh_err_t err = robomesh_signer_sign(&client->signer,
+                                                (const uint8_t *)payload, len,
+                                                sig, sig_len);
     if (err != ROBOMESH_OK) {
         set_error(client, "Failed to sign heartbeat");
         return err;
     }
+    return ROBOMESH_OK;
+}
 
-    char sig_hex[129];
-    bytes_to_hex(sig, sig_len, sig_hex);
+/* Assemble "HEARTBEAT <uuid> <payload> [<sig_hex>]" from the prefix
+   preserialized at client creation. With sig_hex NULL the line ends
+   after the trailing space (the binary-framing form, where the raw
+   signature is appended by frame_send). Returns the line length. */
+static size_t assemble_heartbeat_line(robomesh_client_t *client,
+                                       const char *payload,
+                                       const char *sig_hex, char *line) {
+    size_t n = client->hb_prefix_len;
+    memcpy(line, client->hb_prefix, n);
+    size_t pl = strlen(payload);
+    memcpy(line + n, payload, pl);
+    n += pl;
+    line[n++] = ' ';
+    if (sig_hex) {
+        size_t sl = strlen(sig_hex);
+        memcpy(line + n, sig_hex, sl);
+        n += sl;
+    }
+    line[n] = '\0';
+    return n;
+}
 
-    /* Build the full HEARTBEAT line */
-    char line[MAX_LINE];
-    snprintf(line, sizeof(line), "HEARTBEAT %s %s %s", client->uuid, payload, sig_hex);
+robomesh_err_t robomesh_send_heartbeat(robomesh_client_t *client,
+                                         const char *extra_data_json,
+                                         int ttl) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
 
-    /* Send on a fresh TCP connection with short timeout */
-    int sock = tcp_connect_with_timeout(client->host, client->tcp_port,
-                                         HEARTBEAT_CONNECT_TIMEOUT);
-    if (sock < 0) {
+    char payload[4096];
+    uint8_t sig[64];
+    size_t sig_len = sizeof(sig);
+    robomesh_err_t err = build_heartbeat_parts(client, extra_data_json, ttl,
+                                                payload, sizeof(payload),
+                                                sig, &sig_len);
+    if (err != ROBOMESH_OK) return err;
+
+    /* Both wire representations are cheap to prepare; which one is used
+       depends on the framing the channel negotiated when it was dialed */
+    char sig_hex[129];
+    robomesh_hex_encode(sig, sig_len, sig_hex);
+    char line[MAX_LINE];
+    assemble_heartbeat_line(client, payload, sig_hex, line);
+    char bin_text[MAX_LINE];
+    assemble_heartbeat_line(client, payload, NULL, bin_text);
+
+    /* Send on the persistent heartbeat channel, re-dialing transparently
+       if the kept-alive socket has gone stale since the last beat */
+    uint64_t start_us = robomesh_stats_now_us();
+    pthread_mutex_lock(&client->hb_sock_mutex);
+
+    bool was_open = client->hb_sock >= 0;
+    if (heartbeat_channel_ensure_locked(client) < 0) {
+        pthread_mutex_unlock(&client->hb_sock_mutex);
         set_error(client, "Failed to connect for heartbeat");
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return ROBOMESH_ERR_CONNECT;
     }
 
-    int result = ROBOMESH_OK;
-    if (send_line(sock, line) < 0) {
-        set_error(client, "Failed to send heartbeat");
-        result = ROBOMESH_ERR_SEND;
+    char buf[256];
+    if (heartbeat_channel_exchange_locked(client, line, bin_text, sig, sig_len,
+                                           buf, sizeof(buf)) < 0) {
+        /* A reused connection may have been closed by the server or a NAT
+           timeout — re-dial once and retry before reporting failure */
+        robomesh_stats_add(&client->stats.reconnects, 1);
+        if (!was_open || heartbeat_channel_ensure_locked(client) < 0 ||
+            heartbeat_channel_exchange_locked(client, line, bin_text, sig, sig_len,
+                                               buf, sizeof(buf)) < 0) {
+            pthread_mutex_unlock(&client->hb_sock_mutex);
+            set_error(client, "Failed to send heartbeat");
+            robomesh_stats_add(&client->stats.heartbeat_failures, 1);
+            return ROBOMESH_ERR_SEND;
+        }
+    }
+    pthread_mutex_unlock(&client->hb_sock_mutex);
+
+    if (strcmp(buf, "HEARTBEAT_OK") != 0) {
+        set_error(client, "Heartbeat failed: %s", buf);
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
+        return ROBOMESH_ERR_HEARTBEAT;
+    }
+    robomesh_stats_record(client->stats.heartbeat_rtt,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.heartbeats_sent, 1);
+    return ROBOMESH_OK;
+}
+
+/* Adjust the adaptive interval after a beat. Every three consecutive
+   successes double the interval up to the maximum; any failure or a
+   reconnect underneath the beat (the channel re-dial is counted in
+   stats) snaps it back to the minimum. A low battery reading jumps
+   straight to the maximum — the fewest radio wakeups the caller
+   allowed. The ttl always covers two intervals, so one missed beat
+   never makes the robot look stale. */
+static void hb_adaptive_update(robomesh_client_t *c, bool ok) {
+    uint64_t reconnects = atomic_load_explicit(&c->stats.reconnects,
+                                               memory_order_relaxed);
+    if (!ok || reconnects != c->hb_last_reconnects) {
+        c->hb_streak = 0;
+        c->hb_interval = c->hb_min_interval;
     } else {
-        char buf[256];
-        if (recv_line_raw(sock, buf, sizeof(buf)) < 0) {
-            set_error(client, "Failed to receive heartbeat response");
-            result = ROBOMESH_ERR_RECV;
-        } else if (strcmp(buf, "HEARTBEAT_OK") != 0) {
-            set_error(client, "Heartbeat failed: %s", buf);
-            result = ROBOMESH_ERR_HEARTBEAT;
+        c->hb_streak++;
+        if (c->hb_streak % 3 == 0 && c->hb_interval < c->hb_max_interval) {
+            c->hb_interval *= 2;
+            if (c->hb_interval > c->hb_max_interval)
+                c->hb_interval = c->hb_max_interval;
         }
     }
+    c->hb_last_reconnects = reconnects;
 
-    close(sock);
-    return result;
+    if (c->battery_cb) {
+        int level = c->battery_cb(c->battery_cb_data);
+        if (level >= 0 && level <= 20)
+            c->hb_interval = c->hb_max_interval;
+    }
+    c->hb_ttl = c->hb_interval * 2;
 }
 
 /* Background heartbeat thread */
 static void *heartbeat_thread_func(void *arg) {
     robomesh_client_t *c = (robomesh_client_t *)arg;
     while (c->hb_running) {
-        robomesh_send_heartbeat(c, NULL, c->hb_ttl);
+        robomesh_err_t err = robomesh_send_heartbeat(c, NULL, c->hb_ttl);
+        if (c->hb_adaptive)
+            hb_adaptive_update(c, err == ROBOMESH_OK);
         /* Sleep in 100ms increments so we can check the stop flag */
         for (int i = 0; i < c->hb_interval * 10 && c->hb_running; i++)
             usleep(100000);
@@ -692,6 +1609,7 @@ robomesh_err_t robomesh_start_heartbeat(robomesh_client_t *client,
     if (!client || interval_secs <= 0) return ROBOMESH_ERR_INVALID_ARG;
     if (client->hb_started) return ROBOMESH_OK;
 
+    client->hb_adaptive = false;
     client->hb_interval = interval_secs;
     client->hb_ttl = ttl;
     client->hb_running = true;
@@ -705,6 +1623,37 @@ robomesh_err_t robomesh_start_heartbeat(robomesh_client_t *client,
     return ROBOMESH_OK;
 }
 
+robomesh_err_t robomesh_start_heartbeat_adaptive(robomesh_client_t *client,
+                                                  int min_interval_secs,
+                                                  int max_interval_secs,
+                                                  robomesh_battery_cb battery_cb,
+                                                  void *user_data) {
+    if (!client || min_interval_secs <= 0 ||
+        max_interval_secs < min_interval_secs)
+        return ROBOMESH_ERR_INVALID_ARG;
+    if (client->hb_started) return ROBOMESH_OK;
+
+    client->hb_adaptive = true;
+    client->hb_min_interval = min_interval_secs;
+    client->hb_max_interval = max_interval_secs;
+    client->hb_streak = 0;
+    client->hb_last_reconnects = atomic_load_explicit(&client->stats.reconnects,
+                                                      memory_order_relaxed);
+    client->battery_cb = battery_cb;
+    client->battery_cb_data = user_data;
+    client->hb_interval = min_interval_secs;
+    client->hb_ttl = min_interval_secs * 2;
+    client->hb_running = true;
+
+    if (pthread_create(&client->hb_thread, NULL, heartbeat_thread_func, client) != 0) {
+        client->hb_running = false;
+        set_error(client, "Failed to create heartbeat thread");
+        return ROBOMESH_ERR_ALLOC;
+    }
+    client->hb_started = true;
+    return ROBOMESH_OK;
+}
+
 void robomesh_stop_heartbeat(robomesh_client_t *client) {
     if (!client || !client->hb_started) return;
     client->hb_running = false;
@@ -712,15 +1661,188 @@ void robomesh_stop_heartbeat(robomesh_client_t *client) {
     client->hb_started = false;
 }
 
+/* ── Shared heartbeat scheduler ───────────────────────────── */
+
+/*
+ * One thread services heartbeats for any number of clients, sleeping on
+ * a monotonic condvar until the earliest due beat — no periodic polling,
+ * one wakeup per beat. Beats fire under the scheduler mutex (same
+ * discipline as the engine's heartbeat servicing), so add/remove briefly
+ * wait behind an in-flight beat.
+ */
+
+typedef struct {
+    robomesh_client_t *client;
+    int ttl;
+    int64_t interval_ms;
+    int64_t next_ms;
+} hb_sched_entry_t;
+
+struct robomesh_hb_scheduler {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool started;
+    volatile bool running;
+    hb_sched_entry_t *entries;
+    size_t count;
+    size_t cap;
+};
+
+static int64_t hb_sched_now_ms(void) {
+    return (int64_t)(robomesh_stats_now_us() / 1000);
+}
+
+static void *hb_scheduler_thread_func(void *arg) {
+    robomesh_hb_scheduler_t *s = (robomesh_hb_scheduler_t *)arg;
+
+    pthread_mutex_lock(&s->mutex);
+    while (s->running) {
+        int64_t now = hb_sched_now_ms();
+        int64_t next = INT64_MAX;
+
+        for (size_t i = 0; i < s->count; i++) {
+            hb_sched_entry_t *ent = &s->entries[i];
+            if (ent->next_ms <= now) {
+                robomesh_send_heartbeat(ent->client, NULL, ent->ttl);
+                /* Schedule from the intended time, not the actual one,
+                   so beats don't drift under load. */
+                ent->next_ms += ent->interval_ms;
+                if (ent->next_ms <= now)
+                    ent->next_ms = now + ent->interval_ms;
+            }
+            if (ent->next_ms < next) next = ent->next_ms;
+        }
+
+        if (next == INT64_MAX) {
+            pthread_cond_wait(&s->cond, &s->mutex);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            int64_t wait_ms = next - hb_sched_now_ms();
+            if (wait_ms > 0) {
+                ts.tv_sec += wait_ms / 1000;
+                ts.tv_nsec += (wait_ms % 1000) * 1000000L;
+                if (ts.tv_nsec >= 1000000000L) {
+                    ts.tv_sec++;
+                    ts.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&s->cond, &s->mutex, &ts);
+            }
+        }
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return NULL;
+}
+
+robomesh_hb_scheduler_t *robomesh_hb_scheduler_create(void) {
+    robomesh_hb_scheduler_t *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+
+    pthread_mutex_init(&s->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    s->running = true;
+    if (pthread_create(&s->thread, NULL, hb_scheduler_thread_func, s) != 0) {
+        pthread_cond_destroy(&s->cond);
+        pthread_mutex_destroy(&s->mutex);
+        free(s);
+        return NULL;
+    }
+    s->started = true;
+    return s;
+}
+
+void robomesh_hb_scheduler_destroy(robomesh_hb_scheduler_t *sched) {
+    if (!sched) return;
+
+    if (sched->started) {
+        pthread_mutex_lock(&sched->mutex);
+        sched->running = false;
+        pthread_cond_signal(&sched->cond);
+        pthread_mutex_unlock(&sched->mutex);
+        pthread_join(sched->thread, NULL);
+    }
+    free(sched->entries);
+    pthread_cond_destroy(&sched->cond);
+    pthread_mutex_destroy(&sched->mutex);
+    free(sched);
+}
+
+robomesh_err_t robomesh_hb_scheduler_add(robomesh_hb_scheduler_t *sched,
+                                          robomesh_client_t *client,
+                                          int interval_secs, int ttl) {
+    if (!sched || !client || interval_secs <= 0) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->hb_started) return ROBOMESH_ERR_INVALID_ARG;  /* already on own thread */
+
+    pthread_mutex_lock(&sched->mutex);
+    for (size_t i = 0; i < sched->count; i++) {
+        if (sched->entries[i].client == client) {
+            pthread_mutex_unlock(&sched->mutex);
+            return ROBOMESH_OK;
+        }
+    }
+    if (sched->count == sched->cap) {
+        size_t cap = sched->cap ? sched->cap * 2 : 16;
+        hb_sched_entry_t *grown = realloc(sched->entries, cap * sizeof(*grown));
+        if (!grown) {
+            pthread_mutex_unlock(&sched->mutex);
+            return ROBOMESH_ERR_ALLOC;
+        }
+        sched->entries = grown;
+        sched->cap = cap;
+    }
+    sched->entries[sched->count++] = (hb_sched_entry_t){
+        .client = client,
+        .ttl = ttl,
+        .interval_ms = (int64_t)interval_secs * 1000,
+        .next_ms = hb_sched_now_ms(),  /* first beat fires immediately */
+    };
+    pthread_cond_signal(&sched->cond);
+    pthread_mutex_unlock(&sched->mutex);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_hb_scheduler_remove(robomesh_hb_scheduler_t *sched,
+                                             robomesh_client_t *client) {
+    if (!sched || !client) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&sched->mutex);
+    for (size_t i = 0; i < sched->count; i++) {
+        if (sched->entries[i].client == client) {
+            sched->entries[i] = sched->entries[--sched->count];
+            pthread_cond_signal(&sched->cond);
+            pthread_mutex_unlock(&sched->mutex);
+            return ROBOMESH_OK;
+        }
+    }
+    pthread_mutex_unlock(&sched->mutex);
+    return ROBOMESH_ERR_INVALID_ARG;
+}
+
 /* ── Messaging ────────────────────────────────────────────── */
 
 robomesh_err_t robomesh_send(robomesh_client_t *client, const char *message) {
     if (!client || !client->connected || !message) return ROBOMESH_ERR_INVALID_ARG;
-    if (send_line(client->sock, message) < 0) {
+
+    size_t len = strlen(message);
+    uint64_t start_us = robomesh_stats_now_us();
+    int r = client->binary_framing
+                ? frame_send_maybe_compressed(client, message, len)
+                : send_line(client->sock, client->ssl, message);
+    if (r < 0) {
         set_error(client, "Failed to send message");
         mark_disconnected(client);
         return ROBOMESH_ERR_SEND;
     }
+    robomesh_stats_record(client->stats.send_latency,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.messages_sent, 1);
+    robomesh_stats_add(&client->stats.bytes_sent, len);
     return ROBOMESH_OK;
 }
 
@@ -728,8 +1850,10 @@ robomesh_err_t robomesh_recv(robomesh_client_t *client, char *buf, size_t buf_si
                                int timeout_ms) {
     if (!client || !client->connected || !buf) return ROBOMESH_ERR_INVALID_ARG;
 
-    /* Only poll if no data is already buffered */
-    if (timeout_ms > 0 && client->rbuf_pos >= client->rbuf_len) {
+    /* Only poll if no data is already buffered (including records the
+       TLS layer has read off the socket but not yet delivered) */
+    if (timeout_ms > 0 && client->rbuf_pos >= client->rbuf_len &&
+        !(client->ssl && SSL_pending(client->ssl) > 0)) {
         struct pollfd pfd = { .fd = client->sock, .events = POLLIN };
         int ret = poll(&pfd, 1, timeout_ms);
         if (ret == 0) return ROBOMESH_ERR_TIMEOUT;
@@ -739,32 +1863,141 @@ robomesh_err_t robomesh_recv(robomesh_client_t *client, char *buf, size_t buf_si
         }
     }
 
-    if (recv_line_buffered(client, buf, buf_size) < 0) {
+    int r = client->binary_framing
+                ? frame_recv_maybe_compressed(client, buf, buf_size)
+                : recv_line_buffered(client, buf, buf_size);
+    if (r < 0) {
         set_error(client, "Failed to receive");
         mark_disconnected(client);
         return ROBOMESH_ERR_RECV;
     }
+    robomesh_stats_add(&client->stats.messages_received, 1);
+    robomesh_stats_add(&client->stats.bytes_received, strlen(buf));
     return ROBOMESH_OK;
 }
 
+robomesh_err_t robomesh_recv_view(robomesh_client_t *client, const char **line,
+                                   size_t *line_len, int timeout_ms) {
+    if (!client || !client->connected || !line || !line_len)
+        return ROBOMESH_ERR_INVALID_ARG;
+
+    if (client->binary_framing) {
+        /* Frames bypass the line buffer; read one into it and view that. */
+        if (timeout_ms > 0 && !(client->ssl && SSL_pending(client->ssl) > 0)) {
+            struct pollfd pfd = { .fd = client->sock, .events = POLLIN };
+            int ret = poll(&pfd, 1, timeout_ms);
+            if (ret == 0) return ROBOMESH_ERR_TIMEOUT;
+            if (ret < 0) {
+                set_error(client, "poll error: %s", strerror(errno));
+                return ROBOMESH_ERR_RECV;
+            }
+        }
+        int r = frame_recv_maybe_compressed(client, client->rbuf, READ_BUF_SIZE);
+        if (r < 0) {
+            set_error(client, "Failed to receive");
+            mark_disconnected(client);
+            return ROBOMESH_ERR_RECV;
+        }
+        client->rbuf_pos = 0;
+        client->rbuf_len = 0;
+        *line = client->rbuf;
+        *line_len = (size_t)r;
+        robomesh_stats_add(&client->stats.messages_received, 1);
+        robomesh_stats_add(&client->stats.bytes_received, (uint64_t)r);
+        return ROBOMESH_OK;
+    }
+
+    for (;;) {
+        size_t avail = client->rbuf_len - client->rbuf_pos;
+        if (avail > 0) {
+            char *start = client->rbuf + client->rbuf_pos;
+            char *nl = memchr(start, '\n', avail);
+            if (nl) {
+                *nl = '\0';
+                *line = start;
+                *line_len = (size_t)(nl - start);
+                client->rbuf_pos = (size_t)(nl + 1 - client->rbuf);
+                robomesh_stats_add(&client->stats.messages_received, 1);
+                robomesh_stats_add(&client->stats.bytes_received, *line_len);
+                return ROBOMESH_OK;
+            }
+        }
+
+        /* Partial line: compact it to the front and refill behind it. */
+        if (avail > 0 && client->rbuf_pos > 0)
+            memmove(client->rbuf, client->rbuf + client->rbuf_pos, avail);
+        client->rbuf_pos = 0;
+        client->rbuf_len = avail;
+        if (avail >= READ_BUF_SIZE) {
+            set_error(client, "Line exceeds view buffer; use robomesh_recv()");
+            return ROBOMESH_ERR_RECV;
+        }
+
+        if (timeout_ms > 0 && !(client->ssl && SSL_pending(client->ssl) > 0)) {
+            struct pollfd pfd = { .fd = client->sock, .events = POLLIN };
+            int ret = poll(&pfd, 1, timeout_ms);
+            if (ret == 0) return ROBOMESH_ERR_TIMEOUT;
+            if (ret < 0) {
+                set_error(client, "poll error: %s", strerror(errno));
+                return ROBOMESH_ERR_RECV;
+            }
+        }
+        ssize_t n = client->ssl
+                        ? (ssize_t)SSL_read(client->ssl,
+                                            client->rbuf + client->rbuf_len,
+                                            (int)(READ_BUF_SIZE - client->rbuf_len))
+                        : recv(client->sock, client->rbuf + client->rbuf_len,
+                               READ_BUF_SIZE - client->rbuf_len, 0);
+        if (n <= 0) {
+            set_error(client, "Failed to receive");
+            mark_disconnected(client);
+            return ROBOMESH_ERR_RECV;
+        }
+        client->rbuf_len += (size_t)n;
+    }
+}
+
 /* Background receive thread */
 static void *recv_thread_func(void *arg) {
     robomesh_client_t *c = (robomesh_client_t *)arg;
     char buf[MAX_LINE];
     while (c->recv_running && c->connected) {
         /* Only poll if buffer is empty */
-        if (c->rbuf_pos >= c->rbuf_len) {
+        if (c->rbuf_pos >= c->rbuf_len &&
+            !(c->ssl && SSL_pending(c->ssl) > 0)) {
             struct pollfd pfd = { .fd = c->sock, .events = POLLIN };
             int ret = poll(&pfd, 1, 100); /* 100ms to check stop flag */
             if (ret == 0) continue;
             if (ret < 0 || !c->recv_running) break;
         }
-        if (recv_line_buffered(c, buf, sizeof(buf)) < 0) {
+        int r = c->binary_framing
+                    ? frame_recv_maybe_compressed(c, buf, sizeof(buf))
+                    : recv_line_buffered(c, buf, sizeof(buf));
+        if (r < 0) {
             mark_disconnected(c);
             break;
         }
-        if (c->recv_cb)
+        robomesh_stats_add(&c->stats.messages_received, 1);
+        robomesh_stats_add(&c->stats.bytes_received, strlen(buf));
+        if (c->recv_cb) {
             c->recv_cb(buf, c->recv_cb_data);
+        } else if (c->recv_ring) {
+            /* Queued mode: hand off to the application's thread so a slow
+               consumer never stalls socket draining. */
+            uint32_t head = atomic_load_explicit(&c->recv_ring_head,
+                                                 memory_order_acquire);
+            uint32_t tail = atomic_load_explicit(&c->recv_ring_tail,
+                                                 memory_order_relaxed);
+            if (tail - head == RECV_RING_SLOTS ||
+                (size_t)r >= RECV_RING_SLOT_SIZE) {
+                robomesh_stats_add(&c->stats.recv_overflows, 1);
+            } else {
+                memcpy(c->recv_ring[tail & (RECV_RING_SLOTS - 1)], buf,
+                       (size_t)r + 1);
+                atomic_store_explicit(&c->recv_ring_tail, tail + 1,
+                                      memory_order_release);
+            }
+        }
     }
     c->recv_running = false;
     return NULL;
@@ -800,3 +2033,164 @@ void robomesh_stop_recv(robomesh_client_t *client) {
     pthread_join(client->recv_thread_handle, NULL);
     client->recv_started = false;
 }
+
+robomesh_err_t robomesh_start_recv_queued(robomesh_client_t *client) {
+    if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->recv_started)
+        return client->recv_ring ? ROBOMESH_OK : ROBOMESH_ERR_INVALID_ARG;
+
+    if (!client->recv_ring) {
+        client->recv_ring = malloc((size_t)RECV_RING_SLOTS * RECV_RING_SLOT_SIZE);
+        if (!client->recv_ring) {
+            set_error(client, "Failed to allocate receive ring");
+            return ROBOMESH_ERR_ALLOC;
+        }
+        atomic_store_explicit(&client->recv_ring_head, 0, memory_order_relaxed);
+        atomic_store_explicit(&client->recv_ring_tail, 0, memory_order_relaxed);
+    }
+    client->recv_cb = NULL;
+    client->recv_cb_data = NULL;
+    client->recv_running = true;
+
+    if (pthread_create(&client->recv_thread_handle, NULL, recv_thread_func, client) != 0) {
+        client->recv_running = false;
+        set_error(client, "Failed to create receive thread");
+        return ROBOMESH_ERR_ALLOC;
+    }
+    client->recv_started = true;
+    return ROBOMESH_OK;
+}
+
+int robomesh_poll_messages(robomesh_client_t *client,
+                            robomesh_message_cb callback, void *user_data,
+                            int max_messages) {
+    if (!client || !callback || !client->recv_ring) return -1;
+
+    int n = 0;
+    uint32_t head = atomic_load_explicit(&client->recv_ring_head,
+                                         memory_order_relaxed);
+    while (max_messages <= 0 || n < max_messages) {
+        uint32_t tail = atomic_load_explicit(&client->recv_ring_tail,
+                                             memory_order_acquire);
+        if (head == tail) break;
+        callback(client->recv_ring[head & (RECV_RING_SLOTS - 1)], user_data);
+        head++;
+        atomic_store_explicit(&client->recv_ring_head, head,
+                              memory_order_release);
+        n++;
+    }
+    return n;
+}
+
+/* ── Engine support ───────────────────────────────────────── */
+
+/*
+ * Internal hooks used by robomesh_engine.c to multiplex many clients on
+ * one thread. Declared in robomesh_internal.h; not part of the public API.
+ */
+
+int robomesh_client_sock(robomesh_client_t *client) {
+    return client->sock;
+}
+
+int robomesh_client_hb_fd(robomesh_client_t *client) {
+    pthread_mutex_lock(&client->hb_sock_mutex);
+    heartbeat_channel_ensure_locked(client);
+    int fd = client->hb_sock;
+    pthread_mutex_unlock(&client->hb_sock_mutex);
+    return fd;
+}
+
+robomesh_err_t robomesh_client_hb_fire(robomesh_client_t *client, int ttl) {
+    char payload[4096];
+    uint8_t sig[64];
+    size_t sig_len = sizeof(sig);
+    robomesh_err_t err = build_heartbeat_parts(client, NULL, ttl,
+                                                payload, sizeof(payload),
+                                                sig, &sig_len);
+    if (err != ROBOMESH_OK) return err;
+
+    char sig_hex[129];
+    robomesh_hex_encode(sig, sig_len, sig_hex);
+    char line[MAX_LINE];
+    assemble_heartbeat_line(client, payload, sig_hex, line);
+    char bin_text[MAX_LINE];
+    assemble_heartbeat_line(client, payload, NULL, bin_text);
+
+    pthread_mutex_lock(&client->hb_sock_mutex);
+    if (heartbeat_channel_ensure_locked(client) < 0) {
+        pthread_mutex_unlock(&client->hb_sock_mutex);
+        set_error(client, "Failed to connect for heartbeat");
+        return ROBOMESH_ERR_CONNECT;
+    }
+    int r = client->hb_binary
+                ? frame_send(client->hb_sock, client->hb_ssl, bin_text,
+                             strlen(bin_text), sig, sig_len)
+                : send_line(client->hb_sock, client->hb_ssl, line);
+    if (r < 0) {
+        heartbeat_channel_close_locked(client);
+        pthread_mutex_unlock(&client->hb_sock_mutex);
+        set_error(client, "Failed to send heartbeat");
+        return ROBOMESH_ERR_SEND;
+    }
+    pthread_mutex_unlock(&client->hb_sock_mutex);
+    return ROBOMESH_OK;
+}
+
+int robomesh_client_hb_drain(robomesh_client_t *client) {
+    pthread_mutex_lock(&client->hb_sock_mutex);
+    if (client->hb_sock < 0) {
+        pthread_mutex_unlock(&client->hb_sock_mutex);
+        return -1;
+    }
+    if (client->hb_ssl) {
+        /* TLS heartbeat channels are serviced by the blocking paths */
+        pthread_mutex_unlock(&client->hb_sock_mutex);
+        return 0;
+    }
+
+    char buf[512];
+    int ret = 0;
+    for (;;) {
+        ssize_t n = recv(client->hb_sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        /* Peer closed the channel or hard error — it re-dials on next beat */
+        heartbeat_channel_close_locked(client);
+        ret = -1;
+        break;
+    }
+    pthread_mutex_unlock(&client->hb_sock_mutex);
+    return ret;
+}
+
+int robomesh_client_try_recv_line(robomesh_client_t *client,
+                                   char *buf, size_t buf_size, size_t *pos) {
+    if (client->sock < 0) return -1;
+    if (client->ssl) return -1;  /* engine multiplexing is cleartext-only */
+
+    for (;;) {
+        /* Drain buffered data first */
+        while (client->rbuf_pos < client->rbuf_len) {
+            char ch = client->rbuf[client->rbuf_pos++];
+            if (ch == '\n') {
+                buf[*pos] = '\0';
+                *pos = 0;
+                return 1;
+            }
+            /* Overlong lines are truncated at buf_size, matching
+               recv_line_buffered's behavior */
+            if (*pos < buf_size - 1)
+                buf[(*pos)++] = ch;
+        }
+
+        ssize_t n = recv(client->sock, client->rbuf, READ_BUF_SIZE, MSG_DONTWAIT);
+        if (n > 0) {
+            client->rbuf_pos = 0;
+            client->rbuf_len = (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        return -1;
+    }
+}
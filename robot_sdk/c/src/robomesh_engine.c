@@ -0,0 +1,430 @@
+/**
+ * Robomesh Robot SDK - multi-client event engine implementation.
+ *
+ * One event-loop thread services the main sockets and heartbeat timers
+ * of all registered clients: epoll (or poll) readiness for receives,
+ * and a due-time scan for heartbeats fired on each client's persistent
+ * heartbeat channel via the non-blocking hooks in robomesh_internal.h.
+ */
+
+#include "robomesh_engine.h"
+#include "robomesh_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+/* Per-client line reassembly buffer. Engine-managed clients exchange
+   short control/telemetry lines; anything longer is truncated the same
+   way the blocking receive path truncates at its buffer size. */
+#define ENGINE_LINE_MAX 8192
+#define ENGINE_MAX_EVENTS 64
+
+/* ── Internal structures ──────────────────────────────────── */
+
+typedef struct engine_entry engine_entry_t;
+
+/* What an epoll/poll event points back to: an entry plus which of its
+   two sockets (main or heartbeat channel) became readable. */
+typedef struct {
+    engine_entry_t *entry;
+    bool is_hb;
+} engine_fd_ref_t;
+
+struct engine_entry {
+    robomesh_client_t *client;
+    robomesh_engine_message_cb cb;
+    void *cb_data;
+
+    int hb_interval_ms;       /* 0 = no engine-driven heartbeats */
+    int hb_ttl;
+    int64_t hb_next_ms;       /* next due beat, monotonic clock */
+    bool hb_watched;          /* heartbeat channel fd is registered */
+    int hb_fd;                /* fd currently registered, or -1 */
+
+    bool dead;                /* removed; freed by the engine thread */
+
+    engine_fd_ref_t main_ref;
+    engine_fd_ref_t hb_ref;
+
+    char linebuf[ENGINE_LINE_MAX];
+    size_t linepos;
+};
+
+struct robomesh_engine {
+    pthread_mutex_t mutex;
+    engine_entry_t **entries;
+    size_t count;
+    size_t cap;
+
+    pthread_t thread;
+    volatile bool running;
+    bool started;
+
+    int wake_pipe[2];         /* interrupts the wait on add/remove/stop */
+
+#ifdef __linux__
+    int epfd;
+#endif
+};
+
+/* ── Helpers ─────────────────────────────────────────────── */
+
+static int64_t engine_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+#ifdef __linux__
+static void engine_watch_fd(robomesh_engine_t *e, int fd, engine_fd_ref_t *ref) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = ref };
+    epoll_ctl(e->epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void engine_unwatch_fd(robomesh_engine_t *e, int fd) {
+    if (fd >= 0)
+        epoll_ctl(e->epfd, EPOLL_CTL_DEL, fd, NULL);
+}
+#else
+/* Without epoll the fd set is rebuilt from the entry list every
+   iteration, so registration is implicit. */
+static void engine_watch_fd(robomesh_engine_t *e, int fd, engine_fd_ref_t *ref) {
+    (void)e; (void)fd; (void)ref;
+}
+
+static void engine_unwatch_fd(robomesh_engine_t *e, int fd) {
+    (void)e; (void)fd;
+}
+#endif
+
+static void engine_wake(robomesh_engine_t *e) {
+    char b = 0;
+    ssize_t n = write(e->wake_pipe[1], &b, 1);
+    (void)n;
+}
+
+/* Caller holds the engine mutex. Detaches the entry's fds and marks it
+   for collection by the engine thread. */
+static void engine_entry_kill_locked(robomesh_engine_t *e, engine_entry_t *ent) {
+    if (ent->dead) return;
+    engine_unwatch_fd(e, robomesh_client_sock(ent->client));
+    if (ent->hb_watched) {
+        engine_unwatch_fd(e, ent->hb_fd);
+        ent->hb_watched = false;
+        ent->hb_fd = -1;
+    }
+    ent->dead = true;
+}
+
+/* Caller holds the engine mutex. Frees entries marked dead. */
+static void engine_gc_locked(robomesh_engine_t *e) {
+    size_t w = 0;
+    for (size_t i = 0; i < e->count; i++) {
+        if (e->entries[i]->dead)
+            free(e->entries[i]);
+        else
+            e->entries[w++] = e->entries[i];
+    }
+    e->count = w;
+}
+
+/* Caller holds the engine mutex. Fires due heartbeats and returns the
+   wait timeout in ms until the next due beat (-1 = no timers). */
+static int engine_service_heartbeats_locked(robomesh_engine_t *e) {
+    int64_t now = engine_now_ms();
+    int64_t next = -1;
+
+    for (size_t i = 0; i < e->count; i++) {
+        engine_entry_t *ent = e->entries[i];
+        if (ent->dead || ent->hb_interval_ms <= 0) continue;
+
+        if (ent->hb_next_ms <= now) {
+            if (robomesh_client_hb_fire(ent->client, ent->hb_ttl) == ROBOMESH_OK &&
+                !ent->hb_watched) {
+                int fd = robomesh_client_hb_fd(ent->client);
+                if (fd >= 0) {
+                    engine_watch_fd(e, fd, &ent->hb_ref);
+                    ent->hb_watched = true;
+                    ent->hb_fd = fd;
+                }
+            }
+            ent->hb_next_ms = now + ent->hb_interval_ms;
+        }
+        if (next < 0 || ent->hb_next_ms < next)
+            next = ent->hb_next_ms;
+    }
+
+    if (next < 0) return -1;
+    int64_t delta = next - now;
+    return delta > 0 ? (int)delta : 0;
+}
+
+/* Caller holds the engine mutex. Handles readiness on one fd ref. */
+static void engine_handle_ready_locked(robomesh_engine_t *e, engine_fd_ref_t *ref) {
+    engine_entry_t *ent = ref->entry;
+    if (ent->dead) return;
+
+    if (ref->is_hb) {
+        if (robomesh_client_hb_drain(ent->client) < 0 && ent->hb_watched) {
+            /* Channel died; re-dialed (and re-watched) on the next beat */
+            engine_unwatch_fd(e, ent->hb_fd);
+            ent->hb_watched = false;
+            ent->hb_fd = -1;
+        }
+        return;
+    }
+
+    for (;;) {
+        int r = robomesh_client_try_recv_line(ent->client, ent->linebuf,
+                                               sizeof(ent->linebuf), &ent->linepos);
+        if (r == 0) break;
+        if (r < 0) {
+            if (ent->cb)
+                ent->cb(ent->client, NULL, ent->cb_data);
+            engine_entry_kill_locked(e, ent);
+            break;
+        }
+        if (ent->cb)
+            ent->cb(ent->client, ent->linebuf, ent->cb_data);
+    }
+}
+
+/* ── Event loop ──────────────────────────────────────────── */
+
+static void *engine_thread_func(void *arg) {
+    robomesh_engine_t *e = (robomesh_engine_t *)arg;
+
+    while (e->running) {
+        pthread_mutex_lock(&e->mutex);
+        engine_gc_locked(e);
+        int timeout = engine_service_heartbeats_locked(e);
+        pthread_mutex_unlock(&e->mutex);
+
+#ifdef __linux__
+        struct epoll_event evs[ENGINE_MAX_EVENTS];
+        int n = epoll_wait(e->epfd, evs, ENGINE_MAX_EVENTS, timeout);
+        if (!e->running) break;
+
+        pthread_mutex_lock(&e->mutex);
+        for (int i = 0; i < n; i++) {
+            if (evs[i].data.ptr == NULL) {
+                char drain[64];
+                while (read(e->wake_pipe[0], drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+            engine_handle_ready_locked(e, (engine_fd_ref_t *)evs[i].data.ptr);
+        }
+        pthread_mutex_unlock(&e->mutex);
+#else
+        /* Portable fallback: rebuild the pollfd set each iteration */
+        pthread_mutex_lock(&e->mutex);
+        size_t nfds = 1 + e->count * 2;
+        struct pollfd *pfds = malloc(nfds * sizeof(*pfds));
+        engine_fd_ref_t **refs = malloc(nfds * sizeof(*refs));
+        if (!pfds || !refs) {
+            free(pfds);
+            free(refs);
+            pthread_mutex_unlock(&e->mutex);
+            usleep(10000);
+            continue;
+        }
+        size_t used = 0;
+        pfds[used] = (struct pollfd){ .fd = e->wake_pipe[0], .events = POLLIN };
+        refs[used++] = NULL;
+        for (size_t i = 0; i < e->count; i++) {
+            engine_entry_t *ent = e->entries[i];
+            if (ent->dead) continue;
+            int fd = robomesh_client_sock(ent->client);
+            if (fd >= 0) {
+                pfds[used] = (struct pollfd){ .fd = fd, .events = POLLIN };
+                refs[used++] = &ent->main_ref;
+            }
+            if (ent->hb_watched && ent->hb_fd >= 0) {
+                pfds[used] = (struct pollfd){ .fd = ent->hb_fd, .events = POLLIN };
+                refs[used++] = &ent->hb_ref;
+            }
+        }
+        pthread_mutex_unlock(&e->mutex);
+
+        int n = poll(pfds, (nfds_t)used, timeout);
+        if (!e->running) {
+            free(pfds);
+            free(refs);
+            break;
+        }
+
+        pthread_mutex_lock(&e->mutex);
+        for (size_t i = 0; i < used && n > 0; i++) {
+            if (!(pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            n--;
+            if (refs[i] == NULL) {
+                char drain[64];
+                while (read(e->wake_pipe[0], drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+            engine_handle_ready_locked(e, refs[i]);
+        }
+        pthread_mutex_unlock(&e->mutex);
+        free(pfds);
+        free(refs);
+#endif
+    }
+    return NULL;
+}
+
+/* ── Public API ──────────────────────────────────────────── */
+
+robomesh_engine_t *robomesh_engine_create(void) {
+    robomesh_engine_t *e = calloc(1, sizeof(*e));
+    if (!e) return NULL;
+
+    if (pipe(e->wake_pipe) != 0) {
+        free(e);
+        return NULL;
+    }
+    fcntl(e->wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(e->wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+#ifdef __linux__
+    e->epfd = epoll_create1(0);
+    if (e->epfd < 0) {
+        close(e->wake_pipe[0]);
+        close(e->wake_pipe[1]);
+        free(e);
+        return NULL;
+    }
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(e->epfd, EPOLL_CTL_ADD, e->wake_pipe[0], &ev);
+#endif
+
+    pthread_mutex_init(&e->mutex, NULL);
+    return e;
+}
+
+void robomesh_engine_destroy(robomesh_engine_t *engine) {
+    if (!engine) return;
+
+    robomesh_engine_stop(engine);
+
+    pthread_mutex_lock(&engine->mutex);
+    for (size_t i = 0; i < engine->count; i++)
+        free(engine->entries[i]);
+    free(engine->entries);
+    engine->entries = NULL;
+    engine->count = 0;
+    pthread_mutex_unlock(&engine->mutex);
+
+#ifdef __linux__
+    close(engine->epfd);
+#endif
+    close(engine->wake_pipe[0]);
+    close(engine->wake_pipe[1]);
+    pthread_mutex_destroy(&engine->mutex);
+    free(engine);
+}
+
+robomesh_err_t robomesh_engine_add(robomesh_engine_t *engine,
+                                    robomesh_client_t *client,
+                                    int hb_interval_secs, int hb_ttl,
+                                    robomesh_engine_message_cb callback,
+                                    void *user_data) {
+    if (!engine || !client) return ROBOMESH_ERR_INVALID_ARG;
+    if (robomesh_client_sock(client) < 0) return ROBOMESH_ERR_INVALID_ARG;
+
+    engine_entry_t *ent = calloc(1, sizeof(*ent));
+    if (!ent) return ROBOMESH_ERR_ALLOC;
+
+    ent->client = client;
+    ent->cb = callback;
+    ent->cb_data = user_data;
+    ent->hb_interval_ms = hb_interval_secs > 0 ? hb_interval_secs * 1000 : 0;
+    ent->hb_ttl = hb_ttl;
+    ent->hb_next_ms = engine_now_ms();  /* first beat fires immediately */
+    ent->hb_fd = -1;
+    ent->main_ref = (engine_fd_ref_t){ .entry = ent, .is_hb = false };
+    ent->hb_ref = (engine_fd_ref_t){ .entry = ent, .is_hb = true };
+
+    pthread_mutex_lock(&engine->mutex);
+    if (engine->count == engine->cap) {
+        size_t cap = engine->cap ? engine->cap * 2 : 16;
+        engine_entry_t **grown = realloc(engine->entries, cap * sizeof(*grown));
+        if (!grown) {
+            pthread_mutex_unlock(&engine->mutex);
+            free(ent);
+            return ROBOMESH_ERR_ALLOC;
+        }
+        engine->entries = grown;
+        engine->cap = cap;
+    }
+    engine->entries[engine->count++] = ent;
+    engine_watch_fd(engine, robomesh_client_sock(client), &ent->main_ref);
+    pthread_mutex_unlock(&engine->mutex);
+
+    engine_wake(engine);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_engine_remove(robomesh_engine_t *engine,
+                                       robomesh_client_t *client) {
+    if (!engine || !client) return ROBOMESH_ERR_INVALID_ARG;
+
+    robomesh_err_t err = ROBOMESH_ERR_INVALID_ARG;
+    pthread_mutex_lock(&engine->mutex);
+    for (size_t i = 0; i < engine->count; i++) {
+        if (engine->entries[i]->client == client && !engine->entries[i]->dead) {
+            engine_entry_kill_locked(engine, engine->entries[i]);
+            err = ROBOMESH_OK;
+            break;
+        }
+    }
+    /* If the loop is not running there is no thread to collect the entry */
+    if (!engine->started)
+        engine_gc_locked(engine);
+    pthread_mutex_unlock(&engine->mutex);
+
+    engine_wake(engine);
+    return err;
+}
+
+robomesh_err_t robomesh_engine_start(robomesh_engine_t *engine) {
+    if (!engine) return ROBOMESH_ERR_INVALID_ARG;
+    if (engine->started) return ROBOMESH_OK;
+
+    engine->running = true;
+    if (pthread_create(&engine->thread, NULL, engine_thread_func, engine) != 0) {
+        engine->running = false;
+        return ROBOMESH_ERR_ALLOC;
+    }
+    engine->started = true;
+    return ROBOMESH_OK;
+}
+
+void robomesh_engine_stop(robomesh_engine_t *engine) {
+    if (!engine || !engine->started) return;
+    engine->running = false;
+    engine_wake(engine);
+    pthread_join(engine->thread, NULL);
+    engine->started = false;
+}
+
+size_t robomesh_engine_count(robomesh_engine_t *engine) {
+    if (!engine) return 0;
+    pthread_mutex_lock(&engine->mutex);
+    size_t n = 0;
+    for (size_t i = 0; i < engine->count; i++)
+        if (!engine->entries[i]->dead) n++;
+    pthread_mutex_unlock(&engine->mutex);
+    return n;
+}
@@ -0,0 +1,422 @@
+/**
+ * Robomesh Robot SDK - Gateway multiplexing implementation.
+ *
+ * Wire protocol (line-based; the carrier's framing applies transparently):
+ *   Upgrade:    "GATEWAY"                          -> "GATEWAY_OK"
+ *   Attach:     "GW_ATTACH <ch> <uuid>"            -> "NONCE <hex>"
+ *               "<sig_hex>"                        -> "GW_ATTACH_OK"
+ *   Detach:     "GW_DETACH <ch>"                   -> "GW_DETACH_OK"
+ *   Message:    "GW_MSG <ch> <payload>"            (both directions)
+ *   Heartbeat:  "GW_HEARTBEAT <n> <ch> <payload> <sig_hex> ..."
+ *                                                  -> "GW_HEARTBEAT_OK"
+ *
+ * Heartbeat payloads never contain spaces, so entries pack into one
+ * space-separated line. Every exchange is serialized under the gateway
+ * mutex; asynchronous GW_MSG lines that arrive while an exchange waits
+ * for its response are dispatched to the message callback in place.
+ */
+
+#include "robomesh_gateway.h"
+#include "robomesh_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define MAX_LINE 65536
+#define ERR_MAX 512
+#define GW_RESPONSE_TIMEOUT_MS 30000
+
+/* ── Internal structures ──────────────────────────────────── */
+
+typedef struct {
+    char uuid[256];
+    robomesh_signer_t signer;
+    int64_t seq;
+    int ch;
+} gw_child_t;
+
+struct robomesh_gateway {
+    robomesh_client_t *carrier;
+    char last_error[ERR_MAX];
+
+    pthread_mutex_t mutex;
+    gw_child_t *children;
+    size_t count;
+    size_t cap;
+    int next_ch;
+
+    /* Batched heartbeat assembly buffer, reused across calls */
+    char *hb_buf;
+    size_t hb_buf_cap;
+
+    robomesh_gateway_message_cb msg_cb;
+    void *msg_cb_data;
+};
+
+static void gw_set_error(robomesh_gateway_t *gw, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(gw->last_error, ERR_MAX, fmt, args);
+    va_end(args);
+}
+
+/* Caller holds the mutex. */
+static gw_child_t *gw_find_locked(robomesh_gateway_t *gw, const char *uuid) {
+    for (size_t i = 0; i < gw->count; i++) {
+        if (strcmp(gw->children[i].uuid, uuid) == 0)
+            return &gw->children[i];
+    }
+    return NULL;
+}
+
+/* Caller holds the mutex. */
+static gw_child_t *gw_find_ch_locked(robomesh_gateway_t *gw, int ch) {
+    for (size_t i = 0; i < gw->count; i++) {
+        if (gw->children[i].ch == ch)
+            return &gw->children[i];
+    }
+    return NULL;
+}
+
+/* Dispatch a "GW_MSG <ch> <payload>" line to the message callback.
+   Caller holds the mutex. Unknown channels are dropped (the server may
+   still be flushing messages for a child detached moments ago). */
+static void gw_dispatch_locked(robomesh_gateway_t *gw, const char *line) {
+    char *end;
+    long ch = strtol(line + 7, &end, 10);
+    if (end == line + 7 || *end != ' ') return;
+
+    gw_child_t *child = gw_find_ch_locked(gw, (int)ch);
+    if (child && gw->msg_cb)
+        gw->msg_cb(child->uuid, end + 1, gw->msg_cb_data);
+}
+
+/* Read lines until one that isn't an asynchronous GW_MSG arrives; those
+   are dispatched in place so an exchange never swallows child traffic.
+   Caller holds the mutex. Returns 0 with the response in buf, -1 on
+   carrier error. */
+static int gw_recv_response(robomesh_gateway_t *gw, char *buf, size_t buf_size) {
+    for (;;) {
+        if (robomesh_recv(gw->carrier, buf, buf_size,
+                          GW_RESPONSE_TIMEOUT_MS) != ROBOMESH_OK)
+            return -1;
+        if (strncmp(buf, "GW_MSG ", 7) != 0)
+            return 0;
+        gw_dispatch_locked(gw, buf);
+    }
+}
+
+/* ── Lifecycle ────────────────────────────────────────────── */
+
+robomesh_gateway_t *robomesh_gateway_create(robomesh_client_t *carrier) {
+    if (!carrier || !robomesh_is_connected(carrier) ||
+        !robomesh_get_jwt(carrier))
+        return NULL;
+
+    robomesh_gateway_t *gw = calloc(1, sizeof(*gw));
+    if (!gw) return NULL;
+
+    if (robomesh_send(carrier, "GATEWAY") != ROBOMESH_OK) {
+        free(gw);
+        return NULL;
+    }
+    char buf[256];
+    if (robomesh_recv(carrier, buf, sizeof(buf), GW_RESPONSE_TIMEOUT_MS)
+            != ROBOMESH_OK ||
+        strcmp(buf, "GATEWAY_OK") != 0) {
+        free(gw);
+        return NULL;
+    }
+
+    gw->carrier = carrier;
+    gw->next_ch = 1;
+    pthread_mutex_init(&gw->mutex, NULL);
+    return gw;
+}
+
+void robomesh_gateway_destroy(robomesh_gateway_t *gw) {
+    if (!gw) return;
+    for (size_t i = 0; i < gw->count; i++)
+        robomesh_signer_free(&gw->children[i].signer);
+    free(gw->children);
+    free(gw->hb_buf);
+    pthread_mutex_destroy(&gw->mutex);
+    free(gw);
+}
+
+/* ── Attach / detach ──────────────────────────────────────── */
+
+robomesh_err_t robomesh_gateway_attach(robomesh_gateway_t *gw,
+                                        const char *uuid,
+                                        const robomesh_keypair_t *keypair) {
+    if (!gw || !uuid || uuid[0] == '\0' || strlen(uuid) > 255 || !keypair)
+        return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&gw->mutex);
+    if (gw_find_locked(gw, uuid)) {
+        pthread_mutex_unlock(&gw->mutex);
+        return ROBOMESH_OK;
+    }
+
+    if (gw->count == gw->cap) {
+        size_t cap = gw->cap ? gw->cap * 2 : 16;
+        gw_child_t *grown = realloc(gw->children, cap * sizeof(*grown));
+        if (!grown) {
+            pthread_mutex_unlock(&gw->mutex);
+            gw_set_error(gw, "Failed to grow child table");
+            return ROBOMESH_ERR_ALLOC;
+        }
+        gw->children = grown;
+        gw->cap = cap;
+    }
+
+    gw_child_t *child = &gw->children[gw->count];
+    memset(child, 0, sizeof(*child));
+    strncpy(child->uuid, uuid, sizeof(child->uuid) - 1);
+    child->seq = (int64_t)time(NULL);
+    child->ch = gw->next_ch;
+    if (robomesh_signer_init(&child->signer, keypair) != ROBOMESH_OK) {
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Failed to import keypair for %s", uuid);
+        return ROBOMESH_ERR_CRYPTO;
+    }
+
+    /* Challenge-response with the child's own key, over the carrier */
+    char line[512];
+    snprintf(line, sizeof(line), "GW_ATTACH %d %s", child->ch, uuid);
+    char buf[MAX_LINE];
+    if (robomesh_send(gw->carrier, line) != ROBOMESH_OK ||
+        gw_recv_response(gw, buf, sizeof(buf)) < 0) {
+        goto io_fail;
+    }
+    if (strncmp(buf, "NONCE ", 6) != 0) {
+        robomesh_signer_free(&child->signer);
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Attach refused for %s: %s", uuid, buf);
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    uint8_t nonce_bytes[256];
+    int nonce_len = robomesh_hex_decode(buf + 6, nonce_bytes, sizeof(nonce_bytes));
+    uint8_t sig[64];
+    size_t sig_len = sizeof(sig);
+    if (nonce_len < 0 ||
+        robomesh_signer_sign(&child->signer, nonce_bytes, nonce_len,
+                             sig, &sig_len) != ROBOMESH_OK) {
+        robomesh_signer_free(&child->signer);
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Failed to sign attach nonce for %s", uuid);
+        return ROBOMESH_ERR_CRYPTO;
+    }
+    char sig_hex[129];
+    robomesh_hex_encode(sig, sig_len, sig_hex);
+
+    if (robomesh_send(gw->carrier, sig_hex) != ROBOMESH_OK ||
+        gw_recv_response(gw, buf, sizeof(buf)) < 0) {
+        goto io_fail;
+    }
+    if (strcmp(buf, "GW_ATTACH_OK") != 0) {
+        robomesh_signer_free(&child->signer);
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Attach failed for %s: %s", uuid, buf);
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    gw->count++;
+    gw->next_ch++;
+    pthread_mutex_unlock(&gw->mutex);
+    return ROBOMESH_OK;
+
+io_fail:
+    robomesh_signer_free(&child->signer);
+    pthread_mutex_unlock(&gw->mutex);
+    gw_set_error(gw, "Carrier I/O failed during attach: %s",
+                 robomesh_last_error(gw->carrier));
+    return ROBOMESH_ERR_SEND;
+}
+
+robomesh_err_t robomesh_gateway_detach(robomesh_gateway_t *gw,
+                                        const char *uuid) {
+    if (!gw || !uuid) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&gw->mutex);
+    gw_child_t *child = gw_find_locked(gw, uuid);
+    if (!child) {
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Unknown child: %s", uuid);
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    char line[64];
+    snprintf(line, sizeof(line), "GW_DETACH %d", child->ch);
+    char buf[MAX_LINE];
+    if (robomesh_send(gw->carrier, line) != ROBOMESH_OK ||
+        gw_recv_response(gw, buf, sizeof(buf)) < 0) {
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Carrier I/O failed during detach: %s",
+                     robomesh_last_error(gw->carrier));
+        return ROBOMESH_ERR_SEND;
+    }
+    robomesh_err_t err = ROBOMESH_OK;
+    if (strcmp(buf, "GW_DETACH_OK") != 0) {
+        gw_set_error(gw, "Detach failed for %s: %s", uuid, buf);
+        err = ROBOMESH_ERR_AUTH;
+    }
+
+    /* Drop the child locally either way — its key is gone */
+    robomesh_signer_free(&child->signer);
+    *child = gw->children[--gw->count];
+    pthread_mutex_unlock(&gw->mutex);
+    return err;
+}
+
+size_t robomesh_gateway_count(const robomesh_gateway_t *gw) {
+    if (!gw) return 0;
+    pthread_mutex_lock((pthread_mutex_t *)&gw->mutex);
+    size_t n = gw->count;
+    pthread_mutex_unlock((pthread_mutex_t *)&gw->mutex);
+    return n;
+}
+
+/* ── Messaging ────────────────────────────────────────────── */
+
+robomesh_err_t robomesh_gateway_send(robomesh_gateway_t *gw,
+                                      const char *uuid, const char *message) {
+    if (!gw || !uuid || !message) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&gw->mutex);
+    gw_child_t *child = gw_find_locked(gw, uuid);
+    if (!child) {
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Unknown child: %s", uuid);
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    size_t need = strlen(message) + 32;
+    char stack_line[1024];
+    char *line = stack_line;
+    if (need > sizeof(stack_line)) {
+        line = malloc(need);
+        if (!line) {
+            pthread_mutex_unlock(&gw->mutex);
+            gw_set_error(gw, "Failed to allocate message line");
+            return ROBOMESH_ERR_ALLOC;
+        }
+    }
+    snprintf(line, need, "GW_MSG %d %s", child->ch, message);
+
+    robomesh_err_t err = robomesh_send(gw->carrier, line);
+    if (line != stack_line) free(line);
+    pthread_mutex_unlock(&gw->mutex);
+
+    if (err != ROBOMESH_OK)
+        gw_set_error(gw, "Carrier send failed: %s",
+                     robomesh_last_error(gw->carrier));
+    return err;
+}
+
+void robomesh_gateway_on_message(robomesh_gateway_t *gw,
+                                  robomesh_gateway_message_cb callback,
+                                  void *user_data) {
+    if (!gw) return;
+    pthread_mutex_lock(&gw->mutex);
+    gw->msg_cb = callback;
+    gw->msg_cb_data = user_data;
+    pthread_mutex_unlock(&gw->mutex);
+}
+
+robomesh_err_t robomesh_gateway_poll(robomesh_gateway_t *gw, int timeout_ms) {
+    if (!gw) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&gw->mutex);
+    char buf[MAX_LINE];
+    robomesh_err_t err = robomesh_recv(gw->carrier, buf, sizeof(buf), timeout_ms);
+    if (err == ROBOMESH_OK && strncmp(buf, "GW_MSG ", 7) == 0)
+        gw_dispatch_locked(gw, buf);
+    pthread_mutex_unlock(&gw->mutex);
+    return err;
+}
+
+/* ── Batched heartbeat ────────────────────────────────────── */
+
+/* Worst case per child: " <ch> <payload> <sig_hex>" — a 10-digit
+   channel, a ~60-byte payload, a 128-char signature, and separators. */
+#define GW_HB_ENTRY_MAX 208
+
+robomesh_err_t robomesh_gateway_heartbeat_all(robomesh_gateway_t *gw, int ttl) {
+    if (!gw) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&gw->mutex);
+    if (gw->count == 0) {
+        pthread_mutex_unlock(&gw->mutex);
+        return ROBOMESH_OK;
+    }
+
+    size_t need = 32 + gw->count * GW_HB_ENTRY_MAX;
+    if (gw->hb_buf_cap < need) {
+        char *grown = realloc(gw->hb_buf, need);
+        if (!grown) {
+            pthread_mutex_unlock(&gw->mutex);
+            gw_set_error(gw, "Failed to grow heartbeat buffer");
+            return ROBOMESH_ERR_ALLOC;
+        }
+        gw->hb_buf = grown;
+        gw->hb_buf_cap = need;
+    }
+
+    size_t pos = (size_t)snprintf(gw->hb_buf, gw->hb_buf_cap,
+                                  "GW_HEARTBEAT %zu", gw->count);
+    for (size_t i = 0; i < gw->count; i++) {
+        gw_child_t *child = &gw->children[i];
+        child->seq++;
+
+        char payload[96];
+        size_t plen;
+        if (ttl > 0)
+            plen = (size_t)snprintf(payload, sizeof(payload),
+                                    "{\"seq\":%lld,\"ttl\":%d}",
+                                    (long long)child->seq, ttl);
+        else
+            plen = (size_t)snprintf(payload, sizeof(payload),
+                                    "{\"seq\":%lld}", (long long)child->seq);
+
+        uint8_t sig[64];
+        size_t sig_len = sizeof(sig);
+        if (robomesh_signer_sign(&child->signer, (const uint8_t *)payload,
+                                 plen, sig, &sig_len) != ROBOMESH_OK) {
+            pthread_mutex_unlock(&gw->mutex);
+            gw_set_error(gw, "Failed to sign heartbeat for %s", child->uuid);
+            return ROBOMESH_ERR_CRYPTO;
+        }
+        char sig_hex[129];
+        robomesh_hex_encode(sig, sig_len, sig_hex);
+
+        pos += (size_t)snprintf(gw->hb_buf + pos, gw->hb_buf_cap - pos,
+                                " %d %s %s", child->ch, payload, sig_hex);
+    }
+
+    char buf[MAX_LINE];
+    if (robomesh_send(gw->carrier, gw->hb_buf) != ROBOMESH_OK ||
+        gw_recv_response(gw, buf, sizeof(buf)) < 0) {
+        pthread_mutex_unlock(&gw->mutex);
+        gw_set_error(gw, "Carrier I/O failed during heartbeat: %s",
+                     robomesh_last_error(gw->carrier));
+        return ROBOMESH_ERR_SEND;
+    }
+    pthread_mutex_unlock(&gw->mutex);
+
+    if (strncmp(buf, "GW_HEARTBEAT_OK", 15) != 0) {
+        gw_set_error(gw, "Batched heartbeat failed: %s", buf);
+        return ROBOMESH_ERR_HEARTBEAT;
+    }
+    return ROBOMESH_OK;
+}
+
+const char *robomesh_gateway_last_error(const robomesh_gateway_t *gw) {
+    if (!gw) return "NULL gateway";
+    return gw->last_error;
+}
@@ -0,0 +1,447 @@
+/**
+ * Robomesh Robot SDK - shared internal helpers.
+ *
+ * Included by the TCP, UDP, and MQTT client translation units.
+ * Not part of the public API and not installed.
+ */
+
+#ifndef ROBOMESH_INTERNAL_H
+#define ROBOMESH_INTERNAL_H
+
+#include "robomesh.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <openssl/evp.h>
+
+/* ── Hex codec ────────────────────────────────────────────── */
+
+/*
+ * Table-driven hex encode/decode. Nonces, signatures, and public keys
+ * all pass through these on the auth and heartbeat hot paths, where the
+ * old per-byte sprintf/sscanf loops dominated on slow targets.
+ */
+
+static const char robomesh_hex_enc_table[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/* Maps an ASCII character to its nibble value, or -1 if not a hex digit. */
+static const int8_t robomesh_hex_dec_table[256] = {
+    [0 ... 255] = -1,
+    ['0'] = 0,  ['1'] = 1,  ['2'] = 2,  ['3'] = 3,  ['4'] = 4,
+    ['5'] = 5,  ['6'] = 6,  ['7'] = 7,  ['8'] = 8,  ['9'] = 9,
+    ['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15,
+    ['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15,
+};
+
+/** Encode len bytes as lowercase hex. hex must hold 2*len + 1 bytes. */
+static inline void robomesh_hex_encode(const uint8_t *bytes, size_t len, char *hex) {
+    for (size_t i = 0; i < len; i++) {
+        hex[i * 2]     = robomesh_hex_enc_table[bytes[i] >> 4];
+        hex[i * 2 + 1] = robomesh_hex_enc_table[bytes[i] & 0x0f];
+    }
+    hex[len * 2] = '\0';
+}
+
+/** Decode a hex string into bytes. Returns the decoded length, or -1 on
+    odd length, overflow, or a non-hex character. */
+static inline int robomesh_hex_decode(const char *hex, uint8_t *bytes, size_t max_len) {
+    size_t hex_len = strlen(hex);
+    if (hex_len % 2 != 0 || hex_len / 2 > max_len) return -1;
+    for (size_t i = 0; i < hex_len / 2; i++) {
+        int8_t hi = robomesh_hex_dec_table[(uint8_t)hex[i * 2]];
+        int8_t lo = robomesh_hex_dec_table[(uint8_t)hex[i * 2 + 1]];
+        if (hi < 0 || lo < 0) return -1;
+        bytes[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return (int)(hex_len / 2);
+}
+
+/* ── Cached Ed25519 signing context ───────────────────────── */
+
+/**
+ * Wraps an imported EVP_PKEY so the 32-byte seed is imported once per
+ * client rather than on every signature. Key import is a large fraction
+ * of the Ed25519 sign cost, and heartbeats sign on every beat.
+ */
+typedef struct {
+    EVP_PKEY *pkey;
+} robomesh_signer_t;
+
+/** Import the keypair's private seed. On error, signer->pkey is NULL. */
+static inline robomesh_err_t robomesh_signer_init(robomesh_signer_t *signer,
+                                                   const robomesh_keypair_t *kp) {
+    signer->pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+                                                 kp->private_key, 32);
+    return signer->pkey ? ROBOMESH_OK : ROBOMESH_ERR_CRYPTO;
+}
+
+/** Sign msg with the cached key. Safe for concurrent callers: the EVP_PKEY
+    is read-only after init and each call uses its own digest context. */
+static inline robomesh_err_t robomesh_signer_sign(const robomesh_signer_t *signer,
+                                                   const uint8_t *msg, size_t msg_len,
+                                                   uint8_t *sig, size_t *sig_len) {
+    if (!signer->pkey) return ROBOMESH_ERR_CRYPTO;
+
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (!ctx) return ROBOMESH_ERR_CRYPTO;
+
+    robomesh_err_t err = ROBOMESH_OK;
+    if (EVP_DigestSignInit(ctx, NULL, NULL, NULL, signer->pkey) != 1 ||
+        EVP_DigestSign(ctx, sig, sig_len, msg, msg_len) != 1) {
+        err = ROBOMESH_ERR_CRYPTO;
+    }
+
+    EVP_MD_CTX_free(ctx);
+    return err;
+}
+
+/** Free the cached key. OpenSSL zeroes key material internally. */
+static inline void robomesh_signer_free(robomesh_signer_t *signer) {
+    if (signer->pkey) {
+        EVP_PKEY_free(signer->pkey);
+        signer->pkey = NULL;
+    }
+}
+
+/* ── JSON scanner ─────────────────────────────────────────── */
+
+/*
+ * Single-pass, zero-allocation scanner for the flat JSON objects the
+ * server protocols use. One robomesh_json_parse() tokenizes every
+ * top-level member of a packet into offsets into the receive buffer;
+ * lookups are then memcmps and nothing is copied until the caller asks
+ * for a field. Replaces the strstr-per-field extraction that rescanned
+ * the whole packet for every key and mishandled escaped strings.
+ */
+
+#define ROBOMESH_JSON_MAX_FIELDS 16
+
+typedef struct {
+    const char *key;   /* Points into the scanned buffer, not terminated */
+    size_t key_len;
+    const char *val;   /* Raw value text; quotes stripped for strings */
+    size_t val_len;
+    bool is_string;    /* String values still carry their escapes */
+} robomesh_json_field_t;
+
+typedef struct {
+    robomesh_json_field_t fields[ROBOMESH_JSON_MAX_FIELDS];
+    int count;
+} robomesh_json_t;
+
+/* Advances past a JSON string body (after the opening quote). Returns a
+   pointer to the closing quote, or NULL if the string is unterminated. */
+static inline const char *robomesh_json_skip_string(const char *p) {
+    while (*p && *p != '"') {
+        if (*p == '\\' && p[1]) p++;
+        p++;
+    }
+    return *p == '"' ? p : NULL;
+}
+
+/** Tokenize the top-level members of a JSON object in one pass.
+    Values keep pointing into json, so the buffer must outlive the doc.
+    Returns 0 on success, -1 on malformed input or too many fields. */
+static inline int robomesh_json_parse(const char *json, robomesh_json_t *doc) {
+    doc->count = 0;
+    const char *p = json;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    if (*p != '{') return -1;
+    p++;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == ',') p++;
+        if (*p == '}') return 0;
+        if (*p != '"' || doc->count >= ROBOMESH_JSON_MAX_FIELDS) return -1;
+
+        robomesh_json_field_t *f = &doc->fields[doc->count];
+        f->key = ++p;
+        const char *end = robomesh_json_skip_string(p);
+        if (!end) return -1;
+        f->key_len = (size_t)(end - p);
+        p = end + 1;
+
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p != ':') return -1;
+        p++;
+        while (*p == ' ' || *p == '\t') p++;
+
+        if (*p == '"') {
+            f->is_string = true;
+            f->val = ++p;
+            end = robomesh_json_skip_string(p);
+            if (!end) return -1;
+            f->val_len = (size_t)(end - p);
+            p = end + 1;
+        } else if (*p == '{' || *p == '[') {
+            /* Nested value: bracket-depth scan, strings opaque */
+            f->is_string = false;
+            f->val = p;
+            int depth = 0;
+            do {
+                if (*p == '"') {
+                    end = robomesh_json_skip_string(p + 1);
+                    if (!end) return -1;
+                    p = end;
+                } else if (*p == '{' || *p == '[') {
+                    depth++;
+                } else if (*p == '}' || *p == ']') {
+                    depth--;
+                } else if (*p == '\0') {
+                    return -1;
+                }
+                p++;
+            } while (depth > 0);
+            f->val_len = (size_t)(p - f->val);
+        } else {
+            /* Number, true, false, null */
+            f->is_string = false;
+            f->val = p;
+            while (*p && *p != ',' && *p != '}' &&
+                   *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                p++;
+            if (p == f->val) return -1;
+            f->val_len = (size_t)(p - f->val);
+        }
+        doc->count++;
+    }
+}
+
+/** Look up a top-level field by key. Returns NULL if absent. */
+static inline const robomesh_json_field_t *
+robomesh_json_find(const robomesh_json_t *doc, const char *key) {
+    size_t key_len = strlen(key);
+    for (int i = 0; i < doc->count; i++) {
+        if (doc->fields[i].key_len == key_len &&
+            memcmp(doc->fields[i].key, key, key_len) == 0)
+            return &doc->fields[i];
+    }
+    return NULL;
+}
+
+/** Copy a string field into out, resolving escapes. Returns 0 on
+    success, -1 if the field is absent or not a string. */
+static inline int robomesh_json_copy_string(const robomesh_json_t *doc,
+                                             const char *key,
+                                             char *out, size_t out_size) {
+    const robomesh_json_field_t *f = robomesh_json_find(doc, key);
+    if (!f || !f->is_string) return -1;
+
+    size_t o = 0;
+    for (size_t i = 0; i < f->val_len && o < out_size - 1; i++) {
+        char ch = f->val[i];
+        if (ch == '\\' && i + 1 < f->val_len) {
+            char next = f->val[++i];
+            switch (next) {
+                case 'n': ch = '\n'; break;
+                case 'r': ch = '\r'; break;
+                case 't': ch = '\t'; break;
+                default:  ch = next; break;  /* \" \\ \/ and the rest */
+            }
+        }
+        out[o++] = ch;
+    }
+    out[o] = '\0';
+    return 0;
+}
+
+/* ── Session persistence ──────────────────────────────────── */
+
+/*
+ * Helpers for exporting a still-valid JWT (plus the heartbeat sequence)
+ * to flash/NVRAM and restoring it on the next wake, so battery-powered
+ * devices can skip the Ed25519 handshake entirely. The session blob is
+ * a small JSON object parsed with the scanner above.
+ */
+
+/* Decode base64url (JWT alphabet, no padding). Returns decoded length
+   or -1 on an invalid character or overflow. */
+static inline int robomesh_b64url_decode(const char *in, size_t in_len,
+                                          uint8_t *out, size_t out_size) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    int8_t rev[256];
+    memset(rev, -1, sizeof(rev));
+    for (int i = 0; i < 64; i++)
+        rev[(uint8_t)alphabet[i]] = (int8_t)i;
+
+    size_t o = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < in_len; i++) {
+        int8_t v = rev[(uint8_t)in[i]];
+        if (v < 0) return -1;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (o >= out_size) return -1;
+            out[o++] = (uint8_t)(acc >> bits);
+        }
+    }
+    return (int)o;
+}
+
+/** Extract the exp claim (epoch seconds) from a JWT, or -1 if the token
+    is malformed or carries no expiry. Does not verify the signature —
+    the server re-checks it; this only avoids presenting dead tokens. */
+static inline int64_t robomesh_jwt_expiry(const char *jwt) {
+    const char *p1 = strchr(jwt, '.');
+    if (!p1) return -1;
+    const char *p2 = strchr(p1 + 1, '.');
+    if (!p2) return -1;
+
+    uint8_t claims[2048];
+    int n = robomesh_b64url_decode(p1 + 1, (size_t)(p2 - p1 - 1),
+                                    claims, sizeof(claims) - 1);
+    if (n < 0) return -1;
+    claims[n] = '\0';
+
+    robomesh_json_t doc;
+    if (robomesh_json_parse((const char *)claims, &doc) < 0) return -1;
+    const robomesh_json_field_t *f = robomesh_json_find(&doc, "exp");
+    if (!f || f->is_string) return -1;
+
+    char num[32];
+    size_t len = f->val_len < sizeof(num) - 1 ? f->val_len : sizeof(num) - 1;
+    memcpy(num, f->val, len);
+    num[len] = '\0';
+    return (int64_t)strtoll(num, NULL, 10);
+}
+
+/** Serialize a session blob. Returns 0, or -1 if out is too small. */
+static inline int robomesh_session_pack(const char *uuid, const char *jwt,
+                                         int64_t seq,
+                                         char *out, size_t out_size) {
+    int n = snprintf(out, out_size,
+                     "{\"uuid\":\"%s\",\"seq\":%lld,\"jwt\":\"%s\"}",
+                     uuid, (long long)seq, jwt);
+    return (n < 0 || n >= (int)out_size) ? -1 : 0;
+}
+
+/** Parse and validate a session blob for expect_uuid. Returns 0 on
+    success, -1 on malformed input or UUID mismatch, -2 if the JWT is
+    expired (or expires within 30s — not worth resuming). */
+static inline int robomesh_session_unpack(const char *session,
+                                           const char *expect_uuid,
+                                           char *jwt_out, size_t jwt_size,
+                                           int64_t *seq_out) {
+    robomesh_json_t doc;
+    char uuid[256];
+    if (robomesh_json_parse(session, &doc) < 0 ||
+        robomesh_json_copy_string(&doc, "uuid", uuid, sizeof(uuid)) < 0 ||
+        robomesh_json_copy_string(&doc, "jwt", jwt_out, jwt_size) < 0 ||
+        strcmp(uuid, expect_uuid) != 0)
+        return -1;
+
+    const robomesh_json_field_t *f = robomesh_json_find(&doc, "seq");
+    if (!f || f->is_string) return -1;
+    char num[32];
+    size_t len = f->val_len < sizeof(num) - 1 ? f->val_len : sizeof(num) - 1;
+    memcpy(num, f->val, len);
+    num[len] = '\0';
+    *seq_out = (int64_t)strtoll(num, NULL, 10);
+
+    int64_t exp = robomesh_jwt_expiry(jwt_out);
+    if (exp < 0 || exp <= (int64_t)time(NULL) + 30)
+        return -2;
+    return 0;
+}
+
+/* ── Performance counters ─────────────────────────────────── */
+
+/*
+ * Atomic counterpart of the public robomesh_stats_t. All updates use
+ * relaxed atomics so instrumentation never contends on the client
+ * mutex; readers take a field-by-field snapshot.
+ */
+typedef struct {
+    _Atomic uint64_t messages_sent;
+    _Atomic uint64_t messages_received;
+    _Atomic uint64_t bytes_sent;
+    _Atomic uint64_t bytes_received;
+    _Atomic uint64_t heartbeats_sent;
+    _Atomic uint64_t heartbeat_failures;
+    _Atomic uint64_t reconnects;
+    _Atomic uint64_t auth_failures;
+    _Atomic uint64_t recv_overflows;
+    _Atomic uint64_t heartbeat_rtt[ROBOMESH_STATS_BUCKETS];
+    _Atomic uint64_t send_latency[ROBOMESH_STATS_BUCKETS];
+} robomesh_stats_atomic_t;
+
+/** Relaxed counter increment. */
+static inline void robomesh_stats_add(_Atomic uint64_t *counter, uint64_t v) {
+    atomic_fetch_add_explicit(counter, v, memory_order_relaxed);
+}
+
+/** Monotonic clock in microseconds, for latency sampling. */
+static inline uint64_t robomesh_stats_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/** Record one latency sample into a histogram. Bucket i covers samples
+    below (32 << i) µs; the last bucket collects the overflow. */
+static inline void robomesh_stats_record(_Atomic uint64_t *buckets,
+                                          uint64_t latency_us) {
+    int b = 0;
+    while (b < ROBOMESH_STATS_BUCKETS - 1 &&
+           latency_us >= ((uint64_t)32 << b))
+        b++;
+    atomic_fetch_add_explicit(&buckets[b], 1, memory_order_relaxed);
+}
+
+/** Copy the atomic counters into a plain public snapshot. */
+static inline void robomesh_stats_snapshot(const robomesh_stats_atomic_t *a,
+                                            robomesh_stats_t *out) {
+    out->messages_sent      = atomic_load_explicit(&a->messages_sent, memory_order_relaxed);
+    out->messages_received  = atomic_load_explicit(&a->messages_received, memory_order_relaxed);
+    out->bytes_sent         = atomic_load_explicit(&a->bytes_sent, memory_order_relaxed);
+    out->bytes_received     = atomic_load_explicit(&a->bytes_received, memory_order_relaxed);
+    out->heartbeats_sent    = atomic_load_explicit(&a->heartbeats_sent, memory_order_relaxed);
+    out->heartbeat_failures = atomic_load_explicit(&a->heartbeat_failures, memory_order_relaxed);
+    out->reconnects         = atomic_load_explicit(&a->reconnects, memory_order_relaxed);
+    out->auth_failures      = atomic_load_explicit(&a->auth_failures, memory_order_relaxed);
+    out->recv_overflows     = atomic_load_explicit(&a->recv_overflows, memory_order_relaxed);
+    for (int i = 0; i < ROBOMESH_STATS_BUCKETS; i++) {
+        out->heartbeat_rtt[i] = atomic_load_explicit(&a->heartbeat_rtt[i], memory_order_relaxed);
+        out->send_latency[i]  = atomic_load_explicit(&a->send_latency[i], memory_order_relaxed);
+    }
+}
+
+/* ── Engine support hooks (implemented in robomesh.c) ─────── */
+
+/*
+ * Non-blocking accessors used by the engine to multiplex many clients
+ * from one event loop. None of these are part of the public API.
+ */
+
+/** Main socket fd, or -1 when disconnected. */
+int robomesh_client_sock(robomesh_client_t *client);
+
+/** Persistent heartbeat channel fd, dialing it if needed. -1 on failure. */
+int robomesh_client_hb_fd(robomesh_client_t *client);
+
+/** Sign and send one heartbeat on the channel without waiting for the
+    response (the engine drains responses when the fd becomes readable). */
+robomesh_err_t robomesh_client_hb_fire(robomesh_client_t *client, int ttl);
+
+/** Consume pending heartbeat responses without blocking. Returns 0, or
+    -1 if the channel died (it is closed and re-dialed on the next beat). */
+int robomesh_client_hb_drain(robomesh_client_t *client);
+
+/** Non-blocking line read from the main socket. *pos carries partial-line
+    state across calls and must start at 0. Returns 1 when a complete
+    null-terminated line is in buf, 0 if it would block, -1 on EOF/error. */
+int robomesh_client_try_recv_line(robomesh_client_t *client,
+                                   char *buf, size_t buf_size, size_t *pos);
+
+#endif /* ROBOMESH_INTERNAL_H */
@@ -0,0 +1,201 @@
+/**
+ * Robomesh Robot SDK - Memory-mapped key store implementation.
+ *
+ * File layout (all integers little-endian):
+ *   Header (16 bytes): "RMKS" magic, u32 version (1), u32 record count,
+ *                      u32 reserved (0)
+ *   Records (128 bytes each, sorted by UUID):
+ *     uuid[64]   null-padded UUID string
+ *     seed[32]   raw Ed25519 private seed
+ *     pubkey[32] precomputed public key
+ *
+ * Storing the public key alongside the seed is what removes the OpenSSL
+ * derivation from the load path — robomesh_load_keypair() spends most
+ * of its time re-deriving what the builder already knew.
+ */
+
+#include "robomesh_keystore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define KS_MAGIC "RMKS"
+#define KS_VERSION 1
+#define KS_HEADER_SIZE 16
+#define KS_UUID_SIZE 64
+#define KS_RECORD_SIZE (KS_UUID_SIZE + 32 + 32)
+
+/* ── Internal structures ──────────────────────────────────── */
+
+struct robomesh_keystore {
+    void *map;
+    size_t map_size;
+    const uint8_t *records;
+    size_t count;
+};
+
+static uint32_t ks_read_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void ks_write_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static const uint8_t *ks_record(const robomesh_keystore_t *ks, size_t i) {
+    return ks->records + i * KS_RECORD_SIZE;
+}
+
+/* ── Open / close ─────────────────────────────────────────── */
+
+robomesh_keystore_t *robomesh_keystore_open(const char *path) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < KS_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  /* the mapping keeps the file alive */
+    if (map == MAP_FAILED) return NULL;
+
+    const uint8_t *hdr = map;
+    uint32_t count = ks_read_u32(hdr + 8);
+    if (memcmp(hdr, KS_MAGIC, 4) != 0 ||
+        ks_read_u32(hdr + 4) != KS_VERSION ||
+        (size_t)st.st_size != KS_HEADER_SIZE + (size_t)count * KS_RECORD_SIZE) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    robomesh_keystore_t *ks = calloc(1, sizeof(*ks));
+    if (!ks) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    ks->map = map;
+    ks->map_size = (size_t)st.st_size;
+    ks->records = hdr + KS_HEADER_SIZE;
+    ks->count = count;
+    return ks;
+}
+
+void robomesh_keystore_close(robomesh_keystore_t *ks) {
+    if (!ks) return;
+    munmap(ks->map, ks->map_size);
+    free(ks);
+}
+
+/* ── Lookup ───────────────────────────────────────────────── */
+
+robomesh_err_t robomesh_keystore_get(const robomesh_keystore_t *ks,
+                                      const char *uuid,
+                                      robomesh_keypair_t *kp) {
+    if (!ks || !uuid || !kp || strlen(uuid) >= KS_UUID_SIZE)
+        return ROBOMESH_ERR_INVALID_ARG;
+
+    size_t lo = 0, hi = ks->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = strncmp(uuid, (const char *)ks_record(ks, mid), KS_UUID_SIZE);
+        if (cmp == 0) {
+            const uint8_t *rec = ks_record(ks, mid);
+            memcpy(kp->private_key, rec + KS_UUID_SIZE, 32);
+            memcpy(kp->public_key, rec + KS_UUID_SIZE + 32, 32);
+            return ROBOMESH_OK;
+        }
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return ROBOMESH_ERR_INVALID_ARG;
+}
+
+size_t robomesh_keystore_count(const robomesh_keystore_t *ks) {
+    return ks ? ks->count : 0;
+}
+
+robomesh_err_t robomesh_keystore_get_at(const robomesh_keystore_t *ks,
+                                         size_t index, char *uuid_out,
+                                         robomesh_keypair_t *kp) {
+    if (!ks || index >= ks->count) return ROBOMESH_ERR_INVALID_ARG;
+
+    const uint8_t *rec = ks_record(ks, index);
+    if (uuid_out) {
+        memcpy(uuid_out, rec, KS_UUID_SIZE);
+        uuid_out[KS_UUID_SIZE - 1] = '\0';
+    }
+    if (kp) {
+        memcpy(kp->private_key, rec + KS_UUID_SIZE, 32);
+        memcpy(kp->public_key, rec + KS_UUID_SIZE + 32, 32);
+    }
+    return ROBOMESH_OK;
+}
+
+/* ── Building ─────────────────────────────────────────────── */
+
+static int ks_record_cmp(const void *a, const void *b) {
+    return strncmp((const char *)a, (const char *)b, KS_UUID_SIZE);
+}
+
+robomesh_err_t robomesh_keystore_build(const char *path,
+                                        const char *const *uuids,
+                                        const robomesh_keypair_t *keypairs,
+                                        size_t count) {
+    if (!path || (count > 0 && (!uuids || !keypairs)))
+        return ROBOMESH_ERR_INVALID_ARG;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!uuids[i] || uuids[i][0] == '\0' ||
+            strlen(uuids[i]) >= KS_UUID_SIZE)
+            return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    uint8_t *records = calloc(count ? count : 1, KS_RECORD_SIZE);
+    if (!records) return ROBOMESH_ERR_ALLOC;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *rec = records + i * KS_RECORD_SIZE;
+        strncpy((char *)rec, uuids[i], KS_UUID_SIZE - 1);
+        memcpy(rec + KS_UUID_SIZE, keypairs[i].private_key, 32);
+        memcpy(rec + KS_UUID_SIZE + 32, keypairs[i].public_key, 32);
+    }
+    qsort(records, count, KS_RECORD_SIZE, ks_record_cmp);
+
+    uint8_t hdr[KS_HEADER_SIZE] = {0};
+    memcpy(hdr, KS_MAGIC, 4);
+    ks_write_u32(hdr + 4, KS_VERSION);
+    ks_write_u32(hdr + 8, (uint32_t)count);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        memset(records, 0, count * KS_RECORD_SIZE);
+        free(records);
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    robomesh_err_t err = ROBOMESH_OK;
+    size_t body = count * KS_RECORD_SIZE;
+    if (write(fd, hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr) ||
+        (body > 0 && write(fd, records, body) != (ssize_t)body))
+        err = ROBOMESH_ERR_SEND;
+    close(fd);
+
+    /* Zero the staging copy of the seeds */
+    memset(records, 0, count * KS_RECORD_SIZE);
+    free(records);
+    return err;
+}
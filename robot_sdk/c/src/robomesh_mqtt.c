@@ -6,6 +6,7 @@
 
 #include "robomesh_mqtt.h"
 #include "robomesh.h"
+#include "robomesh_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,18 +19,38 @@
 #include <mosquitto.h>
 #include <openssl/evp.h>
 
+#ifdef ROBOMESH_HAVE_LZ4
+#include <lz4.h>
+#endif
+
 #define JWT_MAX 2048
 #define ERR_MAX 512
 #define TOPIC_MAX 256
 #define PAYLOAD_MAX 8192
 
+/* Async publish ring: must be a power of two (indexes are masked).
+   128 slots absorb >2s of 50Hz telemetry before backpressure. */
+#define MQTT_RING_SLOTS 128
+#define MQTT_RING_SLOT_SIZE 1024
+
+/* Default pipelined in-flight window for persistent QoS 1 sessions */
+#define MQTT_DEFAULT_INFLIGHT 20
+
 /* ── Internal structures ──────────────────────────────────── */
 
+/* One buffered publish awaiting reconnect (offline queue entry) */
+typedef struct mqtt_offline_msg {
+    struct mqtt_offline_msg *next;
+    size_t len;
+    char data[];
+} mqtt_offline_msg_t;
+
 struct robomesh_mqtt_client {
     char uuid[256];
     char host[256];
     int mqtt_port;
     robomesh_keypair_t keypair;
+    robomesh_signer_t signer;
     struct mosquitto *mosq;
     bool connected;
     char jwt[JWT_MAX];
@@ -38,6 +59,9 @@ struct robomesh_mqtt_client {
 
     pthread_mutex_t mutex;
 
+    /* Performance counters (relaxed atomics) */
+    robomesh_stats_atomic_t stats;
+
     /* Topic strings (pre-computed) */
     char topic_auth[TOPIC_MAX];
     char topic_auth_resp[TOPIC_MAX];
@@ -62,6 +86,39 @@ struct robomesh_mqtt_client {
     robomesh_mqtt_message_cb msg_cb;
     void *msg_cb_data;
 
+    /* Optional LZ4 compression (opt-in; compressed payloads carry a
+       5-byte header the server detects). Separate send/recv buffers:
+       sends run on the caller's thread, decompression on mosquitto's
+       network thread. Allocated once on enable, reused per message. */
+    bool compression;
+    size_t comp_threshold;
+    char *comp_buf;           /* send-side scratch */
+    char *comp_rbuf;          /* recv-side scratch */
+    size_t comp_buf_size;
+
+    /* Async publish ring (single producer = caller, single consumer =
+       publish thread). head/tail only ever increase; indexes are
+       masked on use. */
+    char ring_buf[MQTT_RING_SLOTS][MQTT_RING_SLOT_SIZE];
+    size_t ring_len[MQTT_RING_SLOTS];
+    _Atomic uint32_t ring_head;   /* next slot to publish */
+    _Atomic uint32_t ring_tail;   /* next slot to fill */
+    pthread_t pub_thread;
+    volatile bool pub_running;
+    bool pub_started;
+
+    /* Persistent session (opt-in, before connect): clean_session=false
+       under the stable client id, QoS 1 publishes with a pipelined
+       in-flight window, and a byte-bounded offline FIFO that buffers
+       message publishes while the broker is unreachable. */
+    bool persistent;
+    int pub_qos;
+    mqtt_offline_msg_t *offline_head;
+    mqtt_offline_msg_t *offline_tail;
+    size_t offline_bytes;
+    size_t offline_max_bytes;
+    pthread_mutex_t offline_mutex;
+
     /* Background heartbeat thread */
     pthread_t hb_thread;
     volatile bool hb_running;
@@ -70,48 +127,6 @@ struct robomesh_mqtt_client {
     int hb_ttl;
 };
 
-/* ── Hex utilities ────────────────────────────────────────── */
-
-static void mqtt_bytes_to_hex(const uint8_t *bytes, size_t len, char *hex) {
-    for (size_t i = 0; i < len; i++)
-        sprintf(hex + i * 2, "%02x", bytes[i]);
-    hex[len * 2] = '\0';
-}
-
-static int mqtt_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_len) {
-    size_t hex_len = strlen(hex);
-    if (hex_len % 2 != 0 || hex_len / 2 > max_len) return -1;
-    for (size_t i = 0; i < hex_len / 2; i++) {
-        unsigned int val;
-        if (sscanf(hex + i * 2, "%2x", &val) != 1) return -1;
-        bytes[i] = (uint8_t)val;
-    }
-    return (int)(hex_len / 2);
-}
-
-/* ── Ed25519 signing ─────────────────────────────────────── */
-
-static robomesh_err_t mqtt_ed25519_sign(const robomesh_keypair_t *kp,
-                                         const uint8_t *msg, size_t msg_len,
-                                         uint8_t *sig, size_t *sig_len) {
-    EVP_PKEY *pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
-                                                    kp->private_key, 32);
-    if (!pkey) return ROBOMESH_ERR_CRYPTO;
-
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) { EVP_PKEY_free(pkey); return ROBOMESH_ERR_CRYPTO; }
-
-    robomesh_err_t err = ROBOMESH_OK;
-    if (EVP_DigestSignInit(ctx, NULL, NULL, NULL, pkey) != 1 ||
-        EVP_DigestSign(ctx, sig, sig_len, msg, msg_len) != 1) {
-        err = ROBOMESH_ERR_CRYPTO;
-    }
-
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(pkey);
-    return err;
-}
-
 /* ── JSON helpers ────────────────────────────────────────── */
 
 static int mqtt_json_get_string(const char *json, const char *key, char *out, size_t out_size) {
@@ -149,16 +164,91 @@ static void mqtt_set_error(robomesh_mqtt_client_t *c, const char *fmt, ...) {
     va_end(args);
 }
 
+/* ── Offline queue ───────────────────────────────────────── */
+
+/*
+ * Byte-bounded FIFO for message publishes attempted while the broker
+ * is unreachable. Cellular links drop constantly; instead of failing
+ * the send, persistent clients park the wire bytes here and the
+ * connect callback replays them in order. When the bound is hit the
+ * oldest entries are dropped first — recent telemetry wins.
+ */
+
+static robomesh_err_t mqtt_offline_enqueue(robomesh_mqtt_client_t *c,
+                                           const char *data, size_t len) {
+    if (sizeof(mqtt_offline_msg_t) + len > c->offline_max_bytes) {
+        mqtt_set_error(c, "Message larger than offline queue bound");
+        return ROBOMESH_ERR_SEND;
+    }
+
+    mqtt_offline_msg_t *m = malloc(sizeof(*m) + len);
+    if (!m) return ROBOMESH_ERR_ALLOC;
+    m->next = NULL;
+    m->len = len;
+    memcpy(m->data, data, len);
+
+    pthread_mutex_lock(&c->offline_mutex);
+    while (c->offline_head &&
+           c->offline_bytes + sizeof(*m) + len > c->offline_max_bytes) {
+        mqtt_offline_msg_t *old = c->offline_head;
+        c->offline_head = old->next;
+        if (!c->offline_head) c->offline_tail = NULL;
+        c->offline_bytes -= sizeof(*old) + old->len;
+        free(old);
+    }
+    if (c->offline_tail)
+        c->offline_tail->next = m;
+    else
+        c->offline_head = m;
+    c->offline_tail = m;
+    c->offline_bytes += sizeof(*m) + len;
+    pthread_mutex_unlock(&c->offline_mutex);
+    return ROBOMESH_OK;
+}
+
+static void mqtt_offline_drain(robomesh_mqtt_client_t *c) {
+    pthread_mutex_lock(&c->offline_mutex);
+    while (c->offline_head) {
+        mqtt_offline_msg_t *m = c->offline_head;
+        int rc = mosquitto_publish(c->mosq, NULL, c->topic_message,
+                                   (int)m->len, m->data, c->pub_qos, false);
+        if (rc != MOSQ_ERR_SUCCESS)
+            break;  /* still offline; keep the rest for the next connect */
+        robomesh_stats_add(&c->stats.messages_sent, 1);
+        robomesh_stats_add(&c->stats.bytes_sent, m->len);
+        c->offline_head = m->next;
+        if (!c->offline_head) c->offline_tail = NULL;
+        c->offline_bytes -= sizeof(*m) + m->len;
+        free(m);
+    }
+    pthread_mutex_unlock(&c->offline_mutex);
+}
+
+static void mqtt_offline_free(robomesh_mqtt_client_t *c) {
+    mqtt_offline_msg_t *m = c->offline_head;
+    while (m) {
+        mqtt_offline_msg_t *next = m->next;
+        free(m);
+        m = next;
+    }
+    c->offline_head = c->offline_tail = NULL;
+    c->offline_bytes = 0;
+}
+
 /* ── Mosquitto callbacks ─────────────────────────────────── */
 
 static void on_connect_cb(struct mosquitto *mosq, void *obj, int rc) {
     robomesh_mqtt_client_t *c = (robomesh_mqtt_client_t *)obj;
     if (rc == 0) {
         c->connected = true;
-        /* Subscribe to response and incoming message topics */
+        /* Subscribe to response and incoming message topics. Persistent
+           sessions take to_robot at QoS 1 so the broker queues handler
+           messages that arrive during a connection gap. */
         mosquitto_subscribe(mosq, NULL, c->topic_auth_resp, 0);
         mosquitto_subscribe(mosq, NULL, c->topic_heartbeat_resp, 0);
-        mosquitto_subscribe(mosq, NULL, c->topic_to_robot, 0);
+        mosquitto_subscribe(mosq, NULL, c->topic_to_robot, c->persistent ? 1 : 0);
+        if (c->persistent)
+            mqtt_offline_drain(c);
     }
 }
 
@@ -199,6 +289,28 @@ static void on_message_cb(struct mosquitto *mosq, void *obj,
         pthread_cond_signal(&c->hb_cond);
         pthread_mutex_unlock(&c->hb_mutex);
     } else if (strcmp(msg->topic, c->topic_to_robot) == 0) {
+        robomesh_stats_add(&c->stats.messages_received, 1);
+        robomesh_stats_add(&c->stats.bytes_received, len);
+#ifdef ROBOMESH_HAVE_LZ4
+        /* Compressed payload: 0x01 magic + BE32 original length + LZ4
+           block. 0x01 never starts an uncompressed JSON/text message. */
+        if (c->compression && len >= 5 && (uint8_t)payload[0] == 0x01) {
+            size_t orig = ((size_t)(uint8_t)payload[1] << 24) |
+                          ((size_t)(uint8_t)payload[2] << 16) |
+                          ((size_t)(uint8_t)payload[3] << 8) |
+                          (size_t)(uint8_t)payload[4];
+            if (orig < c->comp_buf_size) {
+                int d = LZ4_decompress_safe(payload + 5, c->comp_rbuf,
+                                            (int)(len - 5), (int)orig);
+                if (d >= 0 && (size_t)d == orig) {
+                    c->comp_rbuf[orig] = '\0';
+                    if (c->msg_cb)
+                        c->msg_cb(c->comp_rbuf, c->msg_cb_data);
+                }
+            }
+            return;
+        }
+#endif
         if (c->msg_cb)
             c->msg_cb(payload, c->msg_cb_data);
     }
@@ -218,6 +330,11 @@ robomesh_mqtt_client_t *robomesh_mqtt_create(const robomesh_mqtt_config_t *confi
     strncpy(c->host, config->host, sizeof(c->host) - 1);
     c->mqtt_port = config->mqtt_port > 0 ? config->mqtt_port : 1883;
     memcpy(&c->keypair, config->keypair, sizeof(robomesh_keypair_t));
+    if (robomesh_signer_init(&c->signer, &c->keypair) != ROBOMESH_OK) {
+        memset(&c->keypair, 0, sizeof(robomesh_keypair_t));
+        free(c);
+        return NULL;
+    }
     c->heartbeat_seq = (int64_t)time(NULL);
 
     /* Pre-compute topic strings */
@@ -231,6 +348,7 @@ robomesh_mqtt_client_t *robomesh_mqtt_create(const robomesh_mqtt_config_t *confi
     pthread_mutex_init(&c->mutex, NULL);
     pthread_mutex_init(&c->auth_mutex, NULL);
     pthread_mutex_init(&c->hb_mutex, NULL);
+    pthread_mutex_init(&c->offline_mutex, NULL);
     pthread_cond_init(&c->auth_cond, NULL);
     pthread_cond_init(&c->hb_cond, NULL);
 
@@ -241,6 +359,7 @@ robomesh_mqtt_client_t *robomesh_mqtt_create(const robomesh_mqtt_config_t *confi
     snprintf(client_id, sizeof(client_id), "robomesh-%s", c->uuid);
     c->mosq = mosquitto_new(client_id, true, c);
     if (!c->mosq) {
+        robomesh_signer_free(&c->signer);
         free(c);
         return NULL;
     }
@@ -257,15 +376,57 @@ void robomesh_mqtt_destroy(robomesh_mqtt_client_t *client) {
     robomesh_mqtt_disconnect(client);
     if (client->mosq)
         mosquitto_destroy(client->mosq);
+    free(client->comp_buf);
+    free(client->comp_rbuf);
+    mqtt_offline_free(client);
     pthread_mutex_destroy(&client->mutex);
     pthread_mutex_destroy(&client->auth_mutex);
     pthread_mutex_destroy(&client->hb_mutex);
+    pthread_mutex_destroy(&client->offline_mutex);
     pthread_cond_destroy(&client->auth_cond);
     pthread_cond_destroy(&client->hb_cond);
+    robomesh_signer_free(&client->signer);
     memset(&client->keypair, 0, sizeof(robomesh_keypair_t));
     free(client);
 }
 
+robomesh_err_t robomesh_mqtt_enable_persistent(robomesh_mqtt_client_t *client,
+                                                int max_inflight,
+                                                size_t offline_queue_bytes) {
+    if (!client || max_inflight < 0) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->connected) {
+        mqtt_set_error(client, "Persistent mode must be enabled before connecting");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    if (client->persistent) return ROBOMESH_OK;
+
+    /* Recreate the handle with clean_session=false under the same
+       stable client id — the broker then keeps the subscriptions and
+       any undelivered QoS 1 messages across reconnects. */
+    char client_id[300];
+    snprintf(client_id, sizeof(client_id), "robomesh-%s", client->uuid);
+    int rc = mosquitto_reinitialise(client->mosq, client_id, false, client);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        mqtt_set_error(client, "Failed to reinitialise MQTT handle: %s",
+                       mosquitto_strerror(rc));
+        return ROBOMESH_ERR_CONNECT;
+    }
+    mosquitto_connect_callback_set(client->mosq, on_connect_cb);
+    mosquitto_disconnect_callback_set(client->mosq, on_disconnect_cb);
+    mosquitto_message_callback_set(client->mosq, on_message_cb);
+
+    /* Pipelined QoS 1: libmosquitto keeps up to the window unacked on
+       the wire instead of stop-and-waiting for each PUBACK */
+    mosquitto_max_inflight_messages_set(
+        client->mosq,
+        (unsigned int)(max_inflight > 0 ? max_inflight : MQTT_DEFAULT_INFLIGHT));
+
+    client->persistent = true;
+    client->pub_qos = 1;
+    client->offline_max_bytes = offline_queue_bytes;
+    return ROBOMESH_OK;
+}
+
 robomesh_err_t robomesh_mqtt_connect(robomesh_mqtt_client_t *client) {
     if (!client) return ROBOMESH_ERR_INVALID_ARG;
 
@@ -304,6 +465,8 @@ void robomesh_mqtt_disconnect(robomesh_mqtt_client_t *client) {
         client->hb_started = false;
     }
 
+    robomesh_mqtt_stop_async(client);
+
     if (client->mosq) {
         mosquitto_loop_stop(client->mosq, false);
         mosquitto_disconnect(client->mosq);
@@ -325,6 +488,47 @@ const char *robomesh_mqtt_last_error(const robomesh_mqtt_client_t *client) {
     return client->last_error;
 }
 
+robomesh_err_t robomesh_mqtt_export_session(const robomesh_mqtt_client_t *client,
+                                             char *buf, size_t buf_size) {
+    if (!client || !buf) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->jwt[0] == '\0') return ROBOMESH_ERR_AUTH;
+    if (robomesh_session_pack(client->uuid, client->jwt,
+                              client->heartbeat_seq, buf, buf_size) < 0)
+        return ROBOMESH_ERR_INVALID_ARG;
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_mqtt_import_session(robomesh_mqtt_client_t *client,
+                                             const char *session) {
+    if (!client || !session) return ROBOMESH_ERR_INVALID_ARG;
+
+    char jwt[JWT_MAX];
+    int64_t seq;
+    int r = robomesh_session_unpack(session, client->uuid, jwt, sizeof(jwt), &seq);
+    if (r == -2) {
+        mqtt_set_error(client, "Stored session expired");
+        return ROBOMESH_ERR_AUTH;
+    }
+    if (r < 0) {
+        mqtt_set_error(client, "Invalid session blob");
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    pthread_mutex_lock(&client->mutex);
+    strncpy(client->jwt, jwt, JWT_MAX - 1);
+    if (seq > client->heartbeat_seq)
+        client->heartbeat_seq = seq;
+    pthread_mutex_unlock(&client->mutex);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_mqtt_get_stats(const robomesh_mqtt_client_t *client,
+                                        robomesh_stats_t *stats) {
+    if (!client || !stats) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_stats_snapshot(&client->stats, stats);
+    return ROBOMESH_OK;
+}
+
 /* ── Timed wait helper ───────────────────────────────────── */
 
 static int wait_for_response(pthread_mutex_t *mtx, pthread_cond_t *cond,
@@ -352,8 +556,7 @@ static int wait_for_response(pthread_mutex_t *mtx, pthread_cond_t *cond,
 
 /* ── AUTH flow ───────────────────────────────────────────── */
 
-robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int timeout_ms) {
-    if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+static robomesh_err_t do_mqtt_authenticate(robomesh_mqtt_client_t *client, int timeout_ms) {
     if (timeout_ms <= 0) timeout_ms = 10000;
 
     char payload[PAYLOAD_MAX];
@@ -399,7 +602,7 @@ robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int ti
 
     /* Step 2: Sign nonce */
     uint8_t nonce_bytes[256];
-    int nonce_len = mqtt_hex_to_bytes(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
+    int nonce_len = robomesh_hex_decode(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
     if (nonce_len < 0) {
         mqtt_set_error(client, "Invalid nonce hex");
         return ROBOMESH_ERR_AUTH;
@@ -407,15 +610,15 @@ robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int ti
 
     uint8_t sig[64];
     size_t sig_len = sizeof(sig);
-    robomesh_err_t err = mqtt_ed25519_sign(&client->keypair, nonce_bytes, nonce_len,
-                                            sig, &sig_len);
+    robomesh_err_t err = robomesh_signer_sign(&client->signer, nonce_bytes, nonce_len,
+                                               sig, &sig_len);
     if (err != ROBOMESH_OK) {
         mqtt_set_error(client, "Failed to sign nonce");
         return err;
     }
 
     char sig_hex[129];
-    mqtt_bytes_to_hex(sig, sig_len, sig_hex);
+    robomesh_hex_encode(sig, sig_len, sig_hex);
 
     pthread_mutex_lock(&client->auth_mutex);
     client->auth_received = false;
@@ -458,6 +661,14 @@ robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int ti
     return ROBOMESH_OK;
 }
 
+robomesh_err_t robomesh_mqtt_authenticate(robomesh_mqtt_client_t *client, int timeout_ms) {
+    if (!client || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_err_t err = do_mqtt_authenticate(client, timeout_ms);
+    if (err != ROBOMESH_OK)
+        robomesh_stats_add(&client->stats.auth_failures, 1);
+    return err;
+}
+
 /* ── Heartbeat ───────────────────────────────────────────── */
 
 robomesh_err_t robomesh_mqtt_send_heartbeat(robomesh_mqtt_client_t *client,
@@ -487,17 +698,17 @@ robomesh_err_t robomesh_mqtt_send_heartbeat(robomesh_mqtt_client_t *client,
     /* Sign the raw JSON bytes */
     uint8_t sig[64];
     size_t sig_len = sizeof(sig);
-    robomesh_err_t err = mqtt_ed25519_sign(&client->keypair,
-                                            (const uint8_t *)payload_json,
-                                            strlen(payload_json),
-                                            sig, &sig_len);
+    robomesh_err_t err = robomesh_signer_sign(&client->signer,
+                                               (const uint8_t *)payload_json,
+                                               strlen(payload_json),
+                                               sig, &sig_len);
     if (err != ROBOMESH_OK) {
         mqtt_set_error(client, "Failed to sign heartbeat");
         return err;
     }
 
     char sig_hex[129];
-    mqtt_bytes_to_hex(sig, sig_len, sig_hex);
+    robomesh_hex_encode(sig, sig_len, sig_hex);
 
     /* Build MQTT heartbeat message: payload is a JSON string (escaped) */
     char msg[PAYLOAD_MAX];
@@ -522,12 +733,14 @@ robomesh_err_t robomesh_mqtt_send_heartbeat(robomesh_mqtt_client_t *client,
     client->hb_response[0] = '\0';
     pthread_mutex_unlock(&client->hb_mutex);
 
+    uint64_t start_us = robomesh_stats_now_us();
     mosquitto_publish(client->mosq, NULL, client->topic_heartbeat,
                       (int)strlen(msg), msg, 0, false);
 
     if (wait_for_response(&client->hb_mutex, &client->hb_cond,
                           &client->hb_received, 5000) < 0) {
         mqtt_set_error(client, "Heartbeat timed out");
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return ROBOMESH_ERR_TIMEOUT;
     }
 
@@ -537,9 +750,13 @@ robomesh_err_t robomesh_mqtt_send_heartbeat(robomesh_mqtt_client_t *client,
         char err_msg[256];
         mqtt_json_get_string(client->hb_response, "error", err_msg, sizeof(err_msg));
         mqtt_set_error(client, "Heartbeat: %s", err_msg);
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return ROBOMESH_ERR_HEARTBEAT;
     }
 
+    robomesh_stats_record(client->stats.heartbeat_rtt,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.heartbeats_sent, 1);
     return ROBOMESH_OK;
 }
 
@@ -580,15 +797,162 @@ void robomesh_mqtt_stop_heartbeat(robomesh_mqtt_client_t *client) {
 
 /* ── Messaging ───────────────────────────────────────────── */
 
+robomesh_err_t robomesh_mqtt_enable_compression(robomesh_mqtt_client_t *client,
+                                                 size_t threshold) {
+#ifndef ROBOMESH_HAVE_LZ4
+    (void)threshold;
+    if (client) mqtt_set_error(client, "SDK built without LZ4 support");
+    return ROBOMESH_ERR_INVALID_ARG;
+#else
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->compression) return ROBOMESH_OK;
+
+    if (!client->comp_buf) {
+        client->comp_buf_size = (size_t)LZ4_compressBound(PAYLOAD_MAX) + 5;
+        client->comp_buf = malloc(client->comp_buf_size);
+        client->comp_rbuf = malloc(client->comp_buf_size);
+        if (!client->comp_buf || !client->comp_rbuf) {
+            free(client->comp_buf);
+            free(client->comp_rbuf);
+            client->comp_buf = NULL;
+            client->comp_rbuf = NULL;
+            mqtt_set_error(client, "Failed to allocate compression buffers");
+            return ROBOMESH_ERR_ALLOC;
+        }
+    }
+    client->comp_threshold = threshold > 0 ? threshold : 512;
+    client->compression = true;
+    return ROBOMESH_OK;
+#endif
+}
+
 robomesh_err_t robomesh_mqtt_send(robomesh_mqtt_client_t *client, const char *message) {
-    if (!client || !message || !client->connected) return ROBOMESH_ERR_INVALID_ARG;
+    if (!client || !message) return ROBOMESH_ERR_INVALID_ARG;
+    /* Persistent clients with an offline queue may send while disconnected */
+    if (!client->connected &&
+        !(client->persistent && client->offline_max_bytes > 0))
+        return ROBOMESH_ERR_INVALID_ARG;
 
-    int rc = mosquitto_publish(client->mosq, NULL, client->topic_message,
-                               (int)strlen(message), message, 0, false);
+    size_t len = strlen(message);
+    const char *wire = message;
+    size_t wire_len = len;
+
+#ifdef ROBOMESH_HAVE_LZ4
+    if (client->compression && len >= client->comp_threshold) {
+        int clen = LZ4_compress_default(message, client->comp_buf + 5, (int)len,
+                                        (int)(client->comp_buf_size - 5));
+        if (clen > 0 && (size_t)clen + 5 < len) {
+            client->comp_buf[0] = 0x01;
+            client->comp_buf[1] = (char)((len >> 24) & 0xFF);
+            client->comp_buf[2] = (char)((len >> 16) & 0xFF);
+            client->comp_buf[3] = (char)((len >> 8) & 0xFF);
+            client->comp_buf[4] = (char)(len & 0xFF);
+            wire = client->comp_buf;
+            wire_len = (size_t)clen + 5;
+        }
+        /* Incompressible payloads go out as-is */
+    }
+#endif
+
+    uint64_t start_us = robomesh_stats_now_us();
+    int rc = MOSQ_ERR_NO_CONN;
+    if (client->connected)
+        rc = mosquitto_publish(client->mosq, NULL, client->topic_message,
+                               (int)wire_len, wire, client->pub_qos, false);
     if (rc != MOSQ_ERR_SUCCESS) {
+        if (client->persistent && client->offline_max_bytes > 0 &&
+            (rc == MOSQ_ERR_NO_CONN || rc == MOSQ_ERR_CONN_LOST))
+            return mqtt_offline_enqueue(client, wire, wire_len);
         mqtt_set_error(client, "Failed to publish message: %s", mosquitto_strerror(rc));
         return ROBOMESH_ERR_SEND;
     }
+    robomesh_stats_record(client->stats.send_latency,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.messages_sent, 1);
+    robomesh_stats_add(&client->stats.bytes_sent, len);
+    return ROBOMESH_OK;
+}
+
+/* ── Async publish ───────────────────────────────────────── */
+
+/*
+ * Bounded SPSC ring between the caller's control loop and a publish
+ * thread, so a slow broker stalls the thread instead of the caller.
+ * libmosquitto offers no hook to run work on its own network thread,
+ * so the drain runs on a dedicated thread like the heartbeat loop.
+ */
+
+static void *mqtt_publish_thread_func(void *arg) {
+    robomesh_mqtt_client_t *c = (robomesh_mqtt_client_t *)arg;
+    for (;;) {
+        uint32_t head = atomic_load_explicit(&c->ring_head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&c->ring_tail, memory_order_acquire);
+        if (head == tail) {
+            /* Drain fully before exiting so stop doesn't drop telemetry */
+            if (!c->pub_running) break;
+            usleep(1000);
+            continue;
+        }
+        uint32_t slot = head & (MQTT_RING_SLOTS - 1);
+        size_t len = c->ring_len[slot];
+        int rc = MOSQ_ERR_NO_CONN;
+        if (c->connected)
+            rc = mosquitto_publish(c->mosq, NULL, c->topic_message,
+                                   (int)len, c->ring_buf[slot], c->pub_qos, false);
+        if (rc == MOSQ_ERR_SUCCESS) {
+            robomesh_stats_add(&c->stats.messages_sent, 1);
+            robomesh_stats_add(&c->stats.bytes_sent, len);
+        } else if (c->persistent && c->offline_max_bytes > 0 &&
+                   (rc == MOSQ_ERR_NO_CONN || rc == MOSQ_ERR_CONN_LOST)) {
+            mqtt_offline_enqueue(c, c->ring_buf[slot], len);
+        } else {
+            mqtt_set_error(c, "Async publish failed: %s", mosquitto_strerror(rc));
+        }
+        atomic_store_explicit(&c->ring_head, head + 1, memory_order_release);
+    }
+    return NULL;
+}
+
+robomesh_err_t robomesh_mqtt_start_async(robomesh_mqtt_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->pub_started) return ROBOMESH_OK;
+
+    client->pub_running = true;
+    if (pthread_create(&client->pub_thread, NULL, mqtt_publish_thread_func, client) != 0) {
+        client->pub_running = false;
+        mqtt_set_error(client, "Failed to create publish thread");
+        return ROBOMESH_ERR_ALLOC;
+    }
+    client->pub_started = true;
+    return ROBOMESH_OK;
+}
+
+void robomesh_mqtt_stop_async(robomesh_mqtt_client_t *client) {
+    if (!client || !client->pub_started) return;
+    client->pub_running = false;
+    pthread_join(client->pub_thread, NULL);
+    client->pub_started = false;
+}
+
+robomesh_err_t robomesh_mqtt_send_async(robomesh_mqtt_client_t *client,
+                                         const char *message) {
+    if (!client || !message || !client->pub_started) return ROBOMESH_ERR_INVALID_ARG;
+
+    size_t len = strlen(message);
+    if (len >= MQTT_RING_SLOT_SIZE) {
+        mqtt_set_error(client, "Message too large for async publish (%zu bytes)", len);
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    uint32_t tail = atomic_load_explicit(&client->ring_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&client->ring_head, memory_order_acquire);
+    if (tail - head == MQTT_RING_SLOTS)
+        return ROBOMESH_ERR_WOULD_BLOCK;
+
+    uint32_t slot = tail & (MQTT_RING_SLOTS - 1);
+    memcpy(client->ring_buf[slot], message, len);
+    client->ring_len[slot] = len;
+    atomic_store_explicit(&client->ring_tail, tail + 1, memory_order_release);
     return ROBOMESH_OK;
 }
 
@@ -4,8 +4,11 @@
  * JSON packet-based protocol over UDP with challenge-response auth.
  */
 
+#define _GNU_SOURCE   /* sendmmsg/recvmmsg */
+
 #include "robomesh_udp.h"
 #include "robomesh.h"
+#include "robomesh_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +30,17 @@
 #define JWT_MAX 2048
 #define ERR_MAX 512
 
+/* Batched send queue: slots sized for heartbeat and typical message
+   packets; anything larger goes through the unbatched path */
+#define UDP_BATCH_SLOTS 64
+#define UDP_BATCH_SLOT_SIZE 2048
+
+/* Reliable messaging window (see robomesh_udp_enable_reliability) */
+#define UDP_REL_WINDOW 32
+#define UDP_REL_SLOT_SIZE 2048
+#define UDP_REL_RTO_MS 250        /* initial retransmit timeout */
+#define UDP_REL_RTO_MAX_MS 4000   /* backoff cap */
+
 /* ── Internal structures ──────────────────────────────────── */
 
 struct robomesh_udp_client {
@@ -34,6 +48,7 @@ struct robomesh_udp_client {
     char host[256];
     int udp_port;
     robomesh_keypair_t keypair;
+    robomesh_signer_t signer;
     int sock;
     struct sockaddr_in server_addr;
     char jwt[JWT_MAX];
@@ -42,6 +57,27 @@ struct robomesh_udp_client {
 
     pthread_mutex_t mutex;
 
+    /* Performance counters (relaxed atomics) */
+    robomesh_stats_atomic_t stats;
+
+    /* Batched send queue (flushed in one sendmmsg on Linux) */
+    char batch_buf[UDP_BATCH_SLOTS][UDP_BATCH_SLOT_SIZE];
+    size_t batch_len[UDP_BATCH_SLOTS];
+    int batch_count;
+    pthread_mutex_t batch_mutex;
+
+    /* Reliable messaging window: preallocated slots, no per-packet
+       allocation. Guarded by rel_mutex. */
+    bool rel_enabled;
+    int64_t rel_next_seq;
+    char rel_buf[UDP_REL_WINDOW][UDP_REL_SLOT_SIZE];
+    size_t rel_len[UDP_REL_WINDOW];
+    int64_t rel_seq[UDP_REL_WINDOW];
+    uint64_t rel_resend_us[UDP_REL_WINDOW];
+    int rel_retries[UDP_REL_WINDOW];
+    bool rel_used[UDP_REL_WINDOW];
+    pthread_mutex_t rel_mutex;
+
     /* Background heartbeat thread */
     pthread_t hb_thread;
     volatile bool hb_running;
@@ -50,48 +86,6 @@ struct robomesh_udp_client {
     int hb_ttl;
 };
 
-/* ── Hex utilities (shared with robomesh.c) ──────────────── */
-
-static void udp_bytes_to_hex(const uint8_t *bytes, size_t len, char *hex) {
-    for (size_t i = 0; i < len; i++)
-        sprintf(hex + i * 2, "%02x", bytes[i]);
-    hex[len * 2] = '\0';
-}
-
-static int udp_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_len) {
-    size_t hex_len = strlen(hex);
-    if (hex_len % 2 != 0 || hex_len / 2 > max_len) return -1;
-    for (size_t i = 0; i < hex_len / 2; i++) {
-        unsigned int val;
-        if (sscanf(hex + i * 2, "%2x", &val) != 1) return -1;
-        bytes[i] = (uint8_t)val;
-    }
-    return (int)(hex_len / 2);
-}
-
-/* ── Ed25519 signing ─────────────────────────────────────── */
-
-static robomesh_err_t udp_ed25519_sign(const robomesh_keypair_t *kp,
-                                        const uint8_t *msg, size_t msg_len,
-                                        uint8_t *sig, size_t *sig_len) {
-    EVP_PKEY *pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
-                                                    kp->private_key, 32);
-    if (!pkey) return ROBOMESH_ERR_CRYPTO;
-
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) { EVP_PKEY_free(pkey); return ROBOMESH_ERR_CRYPTO; }
-
-    robomesh_err_t err = ROBOMESH_OK;
-    if (EVP_DigestSignInit(ctx, NULL, NULL, NULL, pkey) != 1 ||
-        EVP_DigestSign(ctx, sig, sig_len, msg, msg_len) != 1) {
-        err = ROBOMESH_ERR_CRYPTO;
-    }
-
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(pkey);
-    return err;
-}
-
 /* ── Error handling ──────────────────────────────────────── */
 
 static void udp_set_error(robomesh_udp_client_t *c, const char *fmt, ...) {
@@ -101,38 +95,6 @@ static void udp_set_error(robomesh_udp_client_t *c, const char *fmt, ...) {
     va_end(args);
 }
 
-/* ── JSON helpers ────────────────────────────────────────── */
-
-/* Simple JSON string value extractor. Writes value into out (max out_size).
-   Returns 0 on success, -1 if key not found. */
-static int json_get_string(const char *json, const char *key, char *out, size_t out_size) {
-    char pattern[128];
-    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
-    const char *start = strstr(json, pattern);
-    if (!start) {
-        /* Try with space after colon */
-        snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
-        start = strstr(json, pattern);
-        if (!start) return -1;
-    }
-    start = strchr(start, ':');
-    if (!start) return -1;
-    start++; /* skip colon */
-    while (*start == ' ') start++;
-    if (*start != '"') return -1;
-    start++; /* skip opening quote */
-
-    size_t i = 0;
-    while (*start && *start != '"' && i < out_size - 1) {
-        if (*start == '\\' && *(start + 1)) {
-            start++; /* skip escape */
-        }
-        out[i++] = *start++;
-    }
-    out[i] = '\0';
-    return 0;
-}
-
 /* ── UDP I/O ─────────────────────────────────────────────── */
 
 static int udp_send_packet(robomesh_udp_client_t *c, const char *json) {
@@ -169,9 +131,16 @@ robomesh_udp_client_t *robomesh_udp_create(const robomesh_udp_config_t *config)
     strncpy(c->host, config->host, sizeof(c->host) - 1);
     c->udp_port = config->udp_port > 0 ? config->udp_port : 5001;
     memcpy(&c->keypair, config->keypair, sizeof(robomesh_keypair_t));
+    if (robomesh_signer_init(&c->signer, &c->keypair) != ROBOMESH_OK) {
+        memset(&c->keypair, 0, sizeof(robomesh_keypair_t));
+        free(c);
+        return NULL;
+    }
     c->sock = -1;
     c->heartbeat_seq = (int64_t)time(NULL);
     pthread_mutex_init(&c->mutex, NULL);
+    pthread_mutex_init(&c->batch_mutex, NULL);
+    pthread_mutex_init(&c->rel_mutex, NULL);
     return c;
 }
 
@@ -179,6 +148,9 @@ void robomesh_udp_destroy(robomesh_udp_client_t *client) {
     if (!client) return;
     robomesh_udp_disconnect(client);
     pthread_mutex_destroy(&client->mutex);
+    pthread_mutex_destroy(&client->batch_mutex);
+    pthread_mutex_destroy(&client->rel_mutex);
+    robomesh_signer_free(&client->signer);
     memset(&client->keypair, 0, sizeof(robomesh_keypair_t));
     free(client);
 }
@@ -240,11 +212,50 @@ const char *robomesh_udp_last_error(const robomesh_udp_client_t *client) {
     return client->last_error;
 }
 
-/* ── AUTH flow ───────────────────────────────────────────── */
+robomesh_err_t robomesh_udp_export_session(const robomesh_udp_client_t *client,
+                                            char *buf, size_t buf_size) {
+    if (!client || !buf) return ROBOMESH_ERR_INVALID_ARG;
+    if (client->jwt[0] == '\0') return ROBOMESH_ERR_AUTH;
+    if (robomesh_session_pack(client->uuid, client->jwt,
+                              client->heartbeat_seq, buf, buf_size) < 0)
+        return ROBOMESH_ERR_INVALID_ARG;
+    return ROBOMESH_OK;
+}
 
-robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
-    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+robomesh_err_t robomesh_udp_import_session(robomesh_udp_client_t *client,
+                                            const char *session) {
+    if (!client || !session) return ROBOMESH_ERR_INVALID_ARG;
+
+    char jwt[JWT_MAX];
+    int64_t seq;
+    int r = robomesh_session_unpack(session, client->uuid, jwt, sizeof(jwt), &seq);
+    if (r == -2) {
+        udp_set_error(client, "Stored session expired");
+        return ROBOMESH_ERR_AUTH;
+    }
+    if (r < 0) {
+        udp_set_error(client, "Invalid session blob");
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    pthread_mutex_lock(&client->mutex);
+    strncpy(client->jwt, jwt, JWT_MAX - 1);
+    if (seq > client->heartbeat_seq)
+        client->heartbeat_seq = seq;
+    pthread_mutex_unlock(&client->mutex);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_udp_get_stats(const robomesh_udp_client_t *client,
+                                       robomesh_stats_t *stats) {
+    if (!client || !stats) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_stats_snapshot(&client->stats, stats);
+    return ROBOMESH_OK;
+}
 
+/* ── AUTH flow ───────────────────────────────────────────── */
+
+static robomesh_err_t do_udp_authenticate(robomesh_udp_client_t *client) {
     if (client->sock < 0) {
         robomesh_err_t err = robomesh_udp_connect(client);
         if (err != ROBOMESH_OK) return err;
@@ -268,15 +279,17 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
         return (n == -2) ? ROBOMESH_ERR_TIMEOUT : ROBOMESH_ERR_RECV;
     }
 
-    /* Check for error */
+    /* Scan the packet once; all fields come from the same pass */
+    robomesh_json_t doc;
     char status[64];
-    if (json_get_string(buf, "status", status, sizeof(status)) < 0) {
+    if (robomesh_json_parse(buf, &doc) < 0 ||
+        robomesh_json_copy_string(&doc, "status", status, sizeof(status)) < 0) {
         udp_set_error(client, "Invalid auth response (no status)");
         return ROBOMESH_ERR_AUTH;
     }
     if (strcmp(status, "error") == 0) {
         char err_msg[256];
-        json_get_string(buf, "error", err_msg, sizeof(err_msg));
+        robomesh_json_copy_string(&doc, "error", err_msg, sizeof(err_msg));
         udp_set_error(client, "Auth step 1 error: %s", err_msg);
         return ROBOMESH_ERR_AUTH;
     }
@@ -286,14 +299,14 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
     }
 
     char nonce_hex[512];
-    if (json_get_string(buf, "nonce", nonce_hex, sizeof(nonce_hex)) < 0) {
+    if (robomesh_json_copy_string(&doc, "nonce", nonce_hex, sizeof(nonce_hex)) < 0) {
         udp_set_error(client, "No nonce in response");
         return ROBOMESH_ERR_AUTH;
     }
 
     /* Step 2: Sign nonce and send back */
     uint8_t nonce_bytes[256];
-    int nonce_len = udp_hex_to_bytes(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
+    int nonce_len = robomesh_hex_decode(nonce_hex, nonce_bytes, sizeof(nonce_bytes));
     if (nonce_len < 0) {
         udp_set_error(client, "Invalid nonce hex");
         return ROBOMESH_ERR_AUTH;
@@ -301,15 +314,15 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
 
     uint8_t sig[64];
     size_t sig_len = sizeof(sig);
-    robomesh_err_t err = udp_ed25519_sign(&client->keypair, nonce_bytes, nonce_len,
-                                           sig, &sig_len);
+    robomesh_err_t err = robomesh_signer_sign(&client->signer, nonce_bytes, nonce_len,
+                                               sig, &sig_len);
     if (err != ROBOMESH_OK) {
         udp_set_error(client, "Failed to sign nonce");
         return err;
     }
 
     char sig_hex[129];
-    udp_bytes_to_hex(sig, sig_len, sig_hex);
+    robomesh_hex_encode(sig, sig_len, sig_hex);
 
     snprintf(packet, sizeof(packet),
              "{\"type\":\"auth\",\"uuid\":\"%s\",\"nonce\":\"%s\",\"signature\":\"%s\"}",
@@ -326,13 +339,14 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
         return (n == -2) ? ROBOMESH_ERR_TIMEOUT : ROBOMESH_ERR_RECV;
     }
 
-    if (json_get_string(buf, "status", status, sizeof(status)) < 0) {
+    if (robomesh_json_parse(buf, &doc) < 0 ||
+        robomesh_json_copy_string(&doc, "status", status, sizeof(status)) < 0) {
         udp_set_error(client, "Invalid auth response (no status)");
         return ROBOMESH_ERR_AUTH;
     }
     if (strcmp(status, "error") == 0) {
         char err_msg[256];
-        json_get_string(buf, "error", err_msg, sizeof(err_msg));
+        robomesh_json_copy_string(&doc, "error", err_msg, sizeof(err_msg));
         udp_set_error(client, "Auth step 2 error: %s", err_msg);
         return ROBOMESH_ERR_AUTH;
     }
@@ -341,7 +355,7 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
         return ROBOMESH_ERR_AUTH;
     }
 
-    if (json_get_string(buf, "jwt", client->jwt, JWT_MAX) < 0) {
+    if (robomesh_json_copy_string(&doc, "jwt", client->jwt, JWT_MAX) < 0) {
         udp_set_error(client, "No JWT in auth response");
         return ROBOMESH_ERR_AUTH;
     }
@@ -349,13 +363,53 @@ robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
     return ROBOMESH_OK;
 }
 
-/* ── Heartbeat ───────────────────────────────────────────── */
+robomesh_err_t robomesh_udp_authenticate(robomesh_udp_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    robomesh_err_t err = do_udp_authenticate(client);
+    if (err != ROBOMESH_OK)
+        robomesh_stats_add(&client->stats.auth_failures, 1);
+    return err;
+}
 
-robomesh_err_t robomesh_udp_send_heartbeat(robomesh_udp_client_t *client,
-                                            const char *extra_data_json,
-                                            int ttl) {
-    if (!client || client->sock < 0) return ROBOMESH_ERR_INVALID_ARG;
+/* ── Reliability window ──────────────────────────────────── */
 
+/* Drop every window slot covered by a cumulative ack. */
+static void udp_rel_ack(robomesh_udp_client_t *c, int64_t ack) {
+    pthread_mutex_lock(&c->rel_mutex);
+    for (int i = 0; i < UDP_REL_WINDOW; i++) {
+        if (c->rel_used[i] && c->rel_seq[i] <= ack)
+            c->rel_used[i] = false;
+    }
+    pthread_mutex_unlock(&c->rel_mutex);
+}
+
+/* Scan an incoming packet for a cumulative "ack" field. Acks ride on
+   any server packet — message responses, dedicated ack packets, and
+   heartbeat responses — so a steady heartbeat doubles as the ack
+   channel. */
+static void udp_rel_note_packet(robomesh_udp_client_t *c, const char *buf) {
+    if (!c->rel_enabled) return;
+
+    robomesh_json_t doc;
+    if (robomesh_json_parse(buf, &doc) < 0) return;
+    const robomesh_json_field_t *f = robomesh_json_find(&doc, "ack");
+    if (!f || f->is_string) return;
+
+    char num[32];
+    size_t len = f->val_len < sizeof(num) - 1 ? f->val_len : sizeof(num) - 1;
+    memcpy(num, f->val, len);
+    num[len] = '\0';
+    udp_rel_ack(c, (int64_t)strtoll(num, NULL, 10));
+}
+
+/* ── Heartbeat ───────────────────────────────────────────── */
+
+/* Build and sign a complete heartbeat packet into out. On success
+   *len_out holds the packet length. */
+static robomesh_err_t udp_build_heartbeat_packet(robomesh_udp_client_t *client,
+                                                  const char *extra_data_json, int ttl,
+                                                  char *out, size_t out_size,
+                                                  int *len_out) {
     /* Atomically increment sequence number */
     pthread_mutex_lock(&client->mutex);
     client->heartbeat_seq++;
@@ -378,25 +432,45 @@ robomesh_err_t robomesh_udp_send_heartbeat(robomesh_udp_client_t *client,
     /* Sign the raw JSON bytes */
     uint8_t sig[64];
     size_t sig_len = sizeof(sig);
-    robomesh_err_t err = udp_ed25519_sign(&client->keypair,
-                                           (const uint8_t *)payload, strlen(payload),
-                                           sig, &sig_len);
+    robomesh_err_t err = robomesh_signer_sign(&client->signer,
+                                               (const uint8_t *)payload, strlen(payload),
+                                               sig, &sig_len);
     if (err != ROBOMESH_OK) {
         udp_set_error(client, "Failed to sign heartbeat");
         return err;
     }
 
     char sig_hex[129];
-    udp_bytes_to_hex(sig, sig_len, sig_hex);
+    robomesh_hex_encode(sig, sig_len, sig_hex);
 
     /* Build UDP packet — payload is a raw JSON object (not string) */
+    int n = snprintf(out, out_size,
+                     "{\"type\":\"heartbeat\",\"uuid\":\"%s\",\"payload\":%s,\"signature\":\"%s\"}",
+                     client->uuid, payload, sig_hex);
+    if (n < 0 || n >= (int)out_size) {
+        udp_set_error(client, "Heartbeat packet too large");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+    *len_out = n;
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_udp_send_heartbeat(robomesh_udp_client_t *client,
+                                            const char *extra_data_json,
+                                            int ttl) {
+    if (!client || client->sock < 0) return ROBOMESH_ERR_INVALID_ARG;
+
     char packet[UDP_MAX_PACKET];
-    snprintf(packet, sizeof(packet),
-             "{\"type\":\"heartbeat\",\"uuid\":\"%s\",\"payload\":%s,\"signature\":\"%s\"}",
-             client->uuid, payload, sig_hex);
+    int packet_len;
+    robomesh_err_t err = udp_build_heartbeat_packet(client, extra_data_json, ttl,
+                                                     packet, sizeof(packet),
+                                                     &packet_len);
+    if (err != ROBOMESH_OK) return err;
 
+    uint64_t start_us = robomesh_stats_now_us();
     if (udp_send_packet(client, packet) < 0) {
         udp_set_error(client, "Failed to send heartbeat");
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return ROBOMESH_ERR_SEND;
     }
 
@@ -405,18 +479,26 @@ robomesh_err_t robomesh_udp_send_heartbeat(robomesh_udp_client_t *client,
     int n = udp_recv_packet(client, buf, sizeof(buf), 5000);
     if (n < 0) {
         udp_set_error(client, "Failed to receive heartbeat response");
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return (n == -2) ? ROBOMESH_ERR_TIMEOUT : ROBOMESH_ERR_RECV;
     }
+    udp_rel_note_packet(client, buf);
 
+    robomesh_json_t doc;
     char status[64];
-    if (json_get_string(buf, "status", status, sizeof(status)) == 0 &&
+    if (robomesh_json_parse(buf, &doc) == 0 &&
+        robomesh_json_copy_string(&doc, "status", status, sizeof(status)) == 0 &&
         strcmp(status, "error") == 0) {
         char err_msg[256];
-        json_get_string(buf, "error", err_msg, sizeof(err_msg));
+        robomesh_json_copy_string(&doc, "error", err_msg, sizeof(err_msg));
         udp_set_error(client, "Heartbeat failed: %s", err_msg);
+        robomesh_stats_add(&client->stats.heartbeat_failures, 1);
         return ROBOMESH_ERR_HEARTBEAT;
     }
 
+    robomesh_stats_record(client->stats.heartbeat_rtt,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.heartbeats_sent, 1);
     return ROBOMESH_OK;
 }
 
@@ -457,11 +539,15 @@ void robomesh_udp_stop_heartbeat(robomesh_udp_client_t *client) {
 
 /* ── Messaging ───────────────────────────────────────────── */
 
-robomesh_err_t robomesh_udp_send(robomesh_udp_client_t *client, const char *message) {
-    if (!client || !message || client->sock < 0) return ROBOMESH_ERR_INVALID_ARG;
+/* Escape message and wrap it in a JWT-authenticated message packet.
+   msg_seq >= 0 adds a "msg_seq" field for the reliability layer.
+   Returns the packet length, or -1 if not authenticated (error set). */
+static int udp_build_message_packet(robomesh_udp_client_t *client,
+                                     const char *message, int64_t msg_seq,
+                                     char *out, size_t out_size) {
     if (client->jwt[0] == '\0') {
         udp_set_error(client, "Not authenticated");
-        return ROBOMESH_ERR_AUTH;
+        return -1;
     }
 
     /* Escape message for JSON embedding */
@@ -485,11 +571,32 @@ robomesh_err_t robomesh_udp_send(robomesh_udp_client_t *client, const char *mess
     }
     escaped[ei] = '\0';
 
+    int n;
+    if (msg_seq >= 0) {
+        n = snprintf(out, out_size,
+                     "{\"type\":\"message\",\"uuid\":\"%s\",\"msg_seq\":%lld,"
+                     "\"jwt\":\"%s\",\"payload\":\"%s\"}",
+                     client->uuid, (long long)msg_seq, client->jwt, escaped);
+    } else {
+        n = snprintf(out, out_size,
+                     "{\"type\":\"message\",\"uuid\":\"%s\",\"jwt\":\"%s\",\"payload\":\"%s\"}",
+                     client->uuid, client->jwt, escaped);
+    }
+    if (n < 0 || n >= (int)out_size) {
+        udp_set_error(client, "Message too large");
+        return -1;
+    }
+    return n;
+}
+
+robomesh_err_t robomesh_udp_send(robomesh_udp_client_t *client, const char *message) {
+    if (!client || !message || client->sock < 0) return ROBOMESH_ERR_INVALID_ARG;
+
     char packet[UDP_MAX_PACKET];
-    snprintf(packet, sizeof(packet),
-             "{\"type\":\"message\",\"uuid\":\"%s\",\"jwt\":\"%s\",\"payload\":\"%s\"}",
-             client->uuid, client->jwt, escaped);
+    if (udp_build_message_packet(client, message, -1, packet, sizeof(packet)) < 0)
+        return ROBOMESH_ERR_AUTH;
 
+    uint64_t start_us = robomesh_stats_now_us();
     if (udp_send_packet(client, packet) < 0) {
         udp_set_error(client, "Failed to send message");
         return ROBOMESH_ERR_SEND;
@@ -502,16 +609,25 @@ robomesh_err_t robomesh_udp_send(robomesh_udp_client_t *client, const char *mess
         udp_set_error(client, "Failed to receive message response");
         return (n == -2) ? ROBOMESH_ERR_TIMEOUT : ROBOMESH_ERR_RECV;
     }
+    udp_rel_note_packet(client, buf);
 
+    robomesh_json_t doc;
     char status[64];
-    if (json_get_string(buf, "status", status, sizeof(status)) == 0 &&
+    if (robomesh_json_parse(buf, &doc) == 0 &&
+        robomesh_json_copy_string(&doc, "status", status, sizeof(status)) == 0 &&
         strcmp(status, "error") == 0) {
         char err_msg[256];
-        json_get_string(buf, "error", err_msg, sizeof(err_msg));
+        robomesh_json_copy_string(&doc, "error", err_msg, sizeof(err_msg));
         udp_set_error(client, "Message failed: %s", err_msg);
         return ROBOMESH_ERR_SEND;
     }
 
+    /* Send latency here covers the full acknowledged round-trip —
+       UDP sends are not complete until the server's ack arrives */
+    robomesh_stats_record(client->stats.send_latency,
+                          robomesh_stats_now_us() - start_us);
+    robomesh_stats_add(&client->stats.messages_sent, 1);
+    robomesh_stats_add(&client->stats.bytes_sent, strlen(message));
     return ROBOMESH_OK;
 }
 
@@ -526,5 +642,270 @@ robomesh_err_t robomesh_udp_recv(robomesh_udp_client_t *client,
         udp_set_error(client, "Failed to receive");
         return ROBOMESH_ERR_RECV;
     }
+    udp_rel_note_packet(client, buf);
+    robomesh_stats_add(&client->stats.messages_received, 1);
+    robomesh_stats_add(&client->stats.bytes_received, (uint64_t)n);
+    return ROBOMESH_OK;
+}
+
+/* ── Batched I/O ─────────────────────────────────────────── */
+
+/* Flush the queue with the batch mutex held. The queue is emptied even
+   on failure — datagrams are fire-and-forget, so there is nothing
+   useful to do with leftovers. */
+static robomesh_err_t udp_flush_locked(robomesh_udp_client_t *c) {
+    int count = c->batch_count;
+    if (count == 0) return ROBOMESH_OK;
+    c->batch_count = 0;
+
+    if (c->sock < 0) {
+        udp_set_error(c, "Not connected");
+        return ROBOMESH_ERR_SEND;
+    }
+
+    uint64_t bytes = 0;
+    for (int i = 0; i < count; i++)
+        bytes += c->batch_len[i];
+
+#ifdef __linux__
+    struct mmsghdr msgs[UDP_BATCH_SLOTS];
+    struct iovec iovs[UDP_BATCH_SLOTS];
+    memset(msgs, 0, sizeof(msgs[0]) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        iovs[i].iov_base = c->batch_buf[i];
+        iovs[i].iov_len = c->batch_len[i];
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &c->server_addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(c->server_addr);
+    }
+    int sent = 0;
+    while (sent < count) {
+        int n = sendmmsg(c->sock, msgs + sent, (unsigned)(count - sent), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            udp_set_error(c, "sendmmsg failed: %s", strerror(errno));
+            return ROBOMESH_ERR_SEND;
+        }
+        sent += n;
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        if (sendto(c->sock, c->batch_buf[i], c->batch_len[i], 0,
+                   (struct sockaddr *)&c->server_addr,
+                   sizeof(c->server_addr)) < 0) {
+            udp_set_error(c, "sendto failed: %s", strerror(errno));
+            return ROBOMESH_ERR_SEND;
+        }
+    }
+#endif
+
+    robomesh_stats_add(&c->stats.messages_sent, (uint64_t)count);
+    robomesh_stats_add(&c->stats.bytes_sent, bytes);
     return ROBOMESH_OK;
 }
+
+/* Append a packet to the queue, flushing first if it is full. */
+static robomesh_err_t udp_batch_append(robomesh_udp_client_t *c,
+                                        const char *packet, size_t len) {
+    if (len >= UDP_BATCH_SLOT_SIZE) {
+        udp_set_error(c, "Packet too large for batching (%zu bytes)", len);
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&c->batch_mutex);
+    if (c->batch_count == UDP_BATCH_SLOTS) {
+        robomesh_err_t err = udp_flush_locked(c);
+        if (err != ROBOMESH_OK) {
+            pthread_mutex_unlock(&c->batch_mutex);
+            return err;
+        }
+    }
+    memcpy(c->batch_buf[c->batch_count], packet, len);
+    c->batch_len[c->batch_count] = len;
+    c->batch_count++;
+    pthread_mutex_unlock(&c->batch_mutex);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_udp_queue_heartbeat(robomesh_udp_client_t *client,
+                                             const char *extra_data_json,
+                                             int ttl) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+
+    char packet[UDP_BATCH_SLOT_SIZE];
+    int len;
+    robomesh_err_t err = udp_build_heartbeat_packet(client, extra_data_json, ttl,
+                                                     packet, sizeof(packet), &len);
+    if (err != ROBOMESH_OK) return err;
+    return udp_batch_append(client, packet, (size_t)len);
+}
+
+robomesh_err_t robomesh_udp_queue_message(robomesh_udp_client_t *client,
+                                           const char *message) {
+    if (!client || !message) return ROBOMESH_ERR_INVALID_ARG;
+
+    char packet[UDP_BATCH_SLOT_SIZE];
+    int len = udp_build_message_packet(client, message, -1, packet, sizeof(packet));
+    if (len < 0) return ROBOMESH_ERR_AUTH;
+    return udp_batch_append(client, packet, (size_t)len);
+}
+
+robomesh_err_t robomesh_udp_flush(robomesh_udp_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+    pthread_mutex_lock(&client->batch_mutex);
+    robomesh_err_t err = udp_flush_locked(client);
+    pthread_mutex_unlock(&client->batch_mutex);
+    return err;
+}
+
+int robomesh_udp_recv_batch(robomesh_udp_client_t *client,
+                             robomesh_udp_packet_t *packets, int count,
+                             int timeout_ms) {
+    if (!client || !packets || count <= 0 || client->sock < 0) return -1;
+    if (count > UDP_BATCH_SLOTS) count = UDP_BATCH_SLOTS;
+
+    /* Wait for the first datagram; the rest are taken without blocking */
+    if (timeout_ms > 0) {
+        struct pollfd pfd = { .fd = client->sock, .events = POLLIN };
+        int ret = poll(&pfd, 1, timeout_ms);
+        if (ret == 0) return 0;
+        if (ret < 0) return -1;
+    }
+
+    int received;
+    uint64_t bytes = 0;
+
+#ifdef __linux__
+    struct mmsghdr msgs[UDP_BATCH_SLOTS];
+    struct iovec iovs[UDP_BATCH_SLOTS];
+    memset(msgs, 0, sizeof(msgs[0]) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        iovs[i].iov_base = packets[i].buf;
+        iovs[i].iov_len = packets[i].buf_size - 1;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    received = recvmmsg(client->sock, msgs, (unsigned)count, MSG_DONTWAIT, NULL);
+    if (received < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    for (int i = 0; i < received; i++) {
+        packets[i].len = msgs[i].msg_len;
+        packets[i].buf[packets[i].len] = '\0';
+        bytes += packets[i].len;
+    }
+#else
+    received = 0;
+    while (received < count) {
+        ssize_t n = recvfrom(client->sock, packets[received].buf,
+                             packets[received].buf_size - 1, MSG_DONTWAIT,
+                             NULL, NULL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return received > 0 ? received : -1;
+        }
+        packets[received].len = (size_t)n;
+        packets[received].buf[n] = '\0';
+        bytes += (uint64_t)n;
+        received++;
+    }
+#endif
+
+    for (int i = 0; i < received; i++)
+        udp_rel_note_packet(client, packets[i].buf);
+    robomesh_stats_add(&client->stats.messages_received, (uint64_t)received);
+    robomesh_stats_add(&client->stats.bytes_received, bytes);
+    return received;
+}
+
+/* ── Reliable messaging ──────────────────────────────────── */
+
+robomesh_err_t robomesh_udp_enable_reliability(robomesh_udp_client_t *client) {
+    if (!client) return ROBOMESH_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&client->rel_mutex);
+    if (!client->rel_enabled) {
+        client->rel_enabled = true;
+        client->rel_next_seq = 1;
+        memset(client->rel_used, 0, sizeof(client->rel_used));
+    }
+    pthread_mutex_unlock(&client->rel_mutex);
+    return ROBOMESH_OK;
+}
+
+robomesh_err_t robomesh_udp_send_reliable(robomesh_udp_client_t *client,
+                                           const char *message) {
+    if (!client || !message || client->sock < 0) return ROBOMESH_ERR_INVALID_ARG;
+    if (!client->rel_enabled) {
+        udp_set_error(client, "Reliability not enabled");
+        return ROBOMESH_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&client->rel_mutex);
+    int slot = -1;
+    for (int i = 0; i < UDP_REL_WINDOW; i++) {
+        if (!client->rel_used[i]) { slot = i; break; }
+    }
+    if (slot < 0) {
+        pthread_mutex_unlock(&client->rel_mutex);
+        udp_set_error(client, "Reliability window full (%d unacked)", UDP_REL_WINDOW);
+        return ROBOMESH_ERR_WOULD_BLOCK;
+    }
+
+    int64_t seq = client->rel_next_seq++;
+    int len = udp_build_message_packet(client, message, seq,
+                                        client->rel_buf[slot], UDP_REL_SLOT_SIZE);
+    if (len < 0) {
+        pthread_mutex_unlock(&client->rel_mutex);
+        return ROBOMESH_ERR_AUTH;
+    }
+
+    client->rel_len[slot] = (size_t)len;
+    client->rel_seq[slot] = seq;
+    client->rel_retries[slot] = 0;
+    client->rel_resend_us[slot] =
+        robomesh_stats_now_us() + (uint64_t)UDP_REL_RTO_MS * 1000;
+    client->rel_used[slot] = true;
+
+    /* A failed first transmission is not fatal — the packet is in the
+       window and the retransmit timer will retry it. */
+    udp_send_packet(client, client->rel_buf[slot]);
+    pthread_mutex_unlock(&client->rel_mutex);
+
+    robomesh_stats_add(&client->stats.messages_sent, 1);
+    robomesh_stats_add(&client->stats.bytes_sent, strlen(message));
+    return ROBOMESH_OK;
+}
+
+int robomesh_udp_reliable_poll(robomesh_udp_client_t *client) {
+    if (!client || !client->rel_enabled || client->sock < 0) return -1;
+
+    int resent = 0;
+    uint64_t now = robomesh_stats_now_us();
+
+    pthread_mutex_lock(&client->rel_mutex);
+    for (int i = 0; i < UDP_REL_WINDOW; i++) {
+        if (!client->rel_used[i] || now < client->rel_resend_us[i]) continue;
+
+        if (udp_send_packet(client, client->rel_buf[i]) == 0)
+            resent++;
+        client->rel_retries[i]++;
+        uint64_t rto = (uint64_t)UDP_REL_RTO_MS << client->rel_retries[i];
+        if (rto > UDP_REL_RTO_MAX_MS) rto = UDP_REL_RTO_MAX_MS;
+        client->rel_resend_us[i] = now + rto * 1000;
+    }
+    pthread_mutex_unlock(&client->rel_mutex);
+    return resent;
+}
+
+int robomesh_udp_reliable_pending(robomesh_udp_client_t *client) {
+    if (!client || !client->rel_enabled) return -1;
+
+    int pending = 0;
+    pthread_mutex_lock(&client->rel_mutex);
+    for (int i = 0; i < UDP_REL_WINDOW; i++) {
+        if (client->rel_used[i]) pending++;
+    }
+    pthread_mutex_unlock(&client->rel_mutex);
+    return pending;
+}
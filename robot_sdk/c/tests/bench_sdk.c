@@ -0,0 +1,260 @@
+/**
+ * Microbenchmarks for the Robomesh C SDK hot paths.
+ *
+ * Runs without a server: socket benchmarks use AF_UNIX socketpairs.
+ * Includes robomesh.c directly for whitebox access to the static
+ * helpers (send_line, recv_line_buffered, build_heartbeat_parts) —
+ * the benchmarks measure exactly the code the library runs.
+ *
+ * Build:
+ *   cd robot_sdk/c && mkdir build && cd build
+ *   cmake .. && make bench_sdk
+ *   ./bench_sdk
+ */
+
+#include "../src/robomesh.c"
+
+#include <sys/socket.h>
+
+/* ── Timing harness ────────────────────────────────────────── */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void report(const char *name, long iters, double elapsed_ns) {
+    printf("  %-28s %10ld ops  %12.0f ops/sec  %8.1f ns/op\n",
+           name, iters, iters / (elapsed_ns / 1e9), elapsed_ns / iters);
+}
+
+/* Prevent the compiler from eliding benchmarked work */
+static volatile uint8_t sink;
+
+/* ── Socket plumbing ───────────────────────────────────────── */
+
+/* Drains and discards everything from a socket until it closes. */
+static void *drain_thread(void *arg) {
+    int fd = *(int *)arg;
+    char buf[65536];
+    while (recv(fd, buf, sizeof(buf), 0) > 0)
+        ;
+    return NULL;
+}
+
+struct feeder_args {
+    int fd;
+    const char *line;   /* without trailing newline */
+    volatile int stop;
+};
+
+/* Writes the same line repeatedly until asked to stop. */
+static void *feeder_thread(void *arg) {
+    struct feeder_args *fa = (struct feeder_args *)arg;
+    while (!fa->stop) {
+        if (send_line(fa->fd, NULL, fa->line) < 0)
+            break;
+    }
+    return NULL;
+}
+
+/* ── Benchmarks ────────────────────────────────────────────── */
+
+static void bench_sign(robomesh_client_t *client) {
+    const long iters = 20000;
+    uint8_t msg[64];
+    memset(msg, 0xA5, sizeof(msg));
+    uint8_t sig[64];
+    size_t sig_len;
+
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+        sig_len = sizeof(sig);
+        robomesh_signer_sign(&client->signer, msg, sizeof(msg), sig, &sig_len);
+    }
+    report("ed25519_sign (64B)", iters, now_ns() - start);
+    sink = sig[0];
+}
+
+static void bench_hex(void) {
+    const long iters = 1000000;
+    uint8_t raw[64];
+    memset(raw, 0x5A, sizeof(raw));
+    char hex[129];
+    uint8_t back[64];
+
+    double start = now_ns();
+    for (long i = 0; i < iters; i++)
+        robomesh_hex_encode(raw, sizeof(raw), hex);
+    report("hex_encode (64B)", iters, now_ns() - start);
+
+    start = now_ns();
+    for (long i = 0; i < iters; i++)
+        robomesh_hex_decode(hex, back, sizeof(back));
+    report("hex_decode (128ch)", iters, now_ns() - start);
+    sink = back[0];
+}
+
+static void bench_heartbeat_build(robomesh_client_t *client) {
+    const long iters = 20000;
+    char payload[4096];
+    uint8_t sig[64];
+    size_t sig_len;
+
+    double start = now_ns();
+    for (long i = 0; i < iters; i++) {
+        sig_len = sizeof(sig);
+        build_heartbeat_parts(client, NULL, 30, payload, sizeof(payload),
+                              sig, &sig_len);
+    }
+    report("heartbeat_build+sign", iters, now_ns() - start);
+
+    /* Line assembly alone (the non-crypto part of a beat) */
+    char sig_hex[129];
+    robomesh_hex_encode(sig, sig_len, sig_hex);
+    char line[MAX_LINE];
+    const long aiters = 1000000;
+    start = now_ns();
+    for (long i = 0; i < aiters; i++)
+        assemble_heartbeat_line(client, payload, sig_hex, line);
+    report("heartbeat_line_assembly", aiters, now_ns() - start);
+    sink = (uint8_t)line[0];
+}
+
+static void bench_send_line(void) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("  send_line: socketpair failed, skipping\n");
+        return;
+    }
+    pthread_t drain;
+    pthread_create(&drain, NULL, drain_thread, &fds[1]);
+
+    /* Typical heartbeat line: ~200 bytes */
+    char line[256];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    const long iters = 200000;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++)
+        send_line(fds[0], NULL, line);
+    report("send_line (255B)", iters, now_ns() - start);
+
+    close(fds[0]);
+    pthread_join(drain, NULL);
+    close(fds[1]);
+}
+
+static void bench_recv_line(robomesh_client_t *client) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("  recv_line_buffered: socketpair failed, skipping\n");
+        return;
+    }
+
+    struct feeder_args fa = { .fd = fds[1], .stop = 0 };
+    char line[256];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    fa.line = line;
+    pthread_t feeder;
+    pthread_create(&feeder, NULL, feeder_thread, &fa);
+
+    int saved_sock = client->sock;
+    client->sock = fds[0];
+    client->rbuf_pos = client->rbuf_len = 0;
+
+    char buf[MAX_LINE];
+    const long iters = 200000;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++)
+        recv_line_buffered(client, buf, sizeof(buf));
+    report("recv_line_buffered (255B)", iters, now_ns() - start);
+
+    fa.stop = 1;
+    close(fds[0]);
+    pthread_join(feeder, NULL);
+    close(fds[1]);
+
+    client->sock = saved_sock;
+    client->rbuf_pos = client->rbuf_len = 0;
+    sink = (uint8_t)buf[0];
+}
+
+static void bench_recv_view(robomesh_client_t *client) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        printf("  recv_view: socketpair failed, skipping\n");
+        return;
+    }
+
+    struct feeder_args fa = { .fd = fds[1], .stop = 0 };
+    char line[256];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    fa.line = line;
+    pthread_t feeder;
+    pthread_create(&feeder, NULL, feeder_thread, &fa);
+
+    int saved_sock = client->sock;
+    bool saved_connected = client->connected;
+    client->sock = fds[0];
+    client->connected = true;
+    client->rbuf_pos = client->rbuf_len = 0;
+
+    const char *view;
+    size_t view_len = 0;
+    const long iters = 200000;
+    double start = now_ns();
+    for (long i = 0; i < iters; i++)
+        robomesh_recv_view(client, &view, &view_len, 0);
+    report("recv_view (255B)", iters, now_ns() - start);
+
+    fa.stop = 1;
+    close(fds[0]);
+    pthread_join(feeder, NULL);
+    close(fds[1]);
+
+    client->sock = saved_sock;
+    client->connected = saved_connected;
+    client->rbuf_pos = client->rbuf_len = 0;
+    sink = (uint8_t)view_len;
+}
+
+/* ── Main ──────────────────────────────────────────────────── */
+
+int main(void) {
+    robomesh_keypair_t kp;
+    if (robomesh_generate_keypair(&kp) != ROBOMESH_OK) {
+        fprintf(stderr, "keypair generation failed\n");
+        return 1;
+    }
+
+    robomesh_config_t config = {
+        .uuid = "bench-robot-000",
+        .host = "localhost",
+        .tcp_port = 0,
+        .device_type = "bench",
+        .keypair = &kp,
+    };
+    robomesh_client_t *client = robomesh_client_create(&config);
+    if (!client) {
+        fprintf(stderr, "client creation failed\n");
+        return 1;
+    }
+
+    printf("Robomesh C SDK microbenchmarks\n");
+    printf("==============================\n");
+
+    bench_sign(client);
+    bench_hex();
+    bench_heartbeat_build(client);
+    bench_send_line();
+    bench_recv_line(client);
+    bench_recv_view(client);
+
+    robomesh_client_destroy(client);
+    return 0;
+}
@@ -0,0 +1,426 @@
+/**
+ * Fleet load-test harness for the Robomesh C SDK.
+ *
+ * Spawns N concurrent simulated robots on the epoll engine against a
+ * live roboserver, drives configurable auth/heartbeat/message rates,
+ * and reports per-operation latency percentiles and error rates over
+ * time — the capacity check run before every rollout, and the
+ * macro-benchmark for SDK optimizations.
+ *
+ * Requires a running roboserver (use docker-compose.dev.yml).
+ *
+ * Build:
+ *   cd robot_sdk/c && mkdir build && cd build
+ *   cmake .. && make loadtest_fleet
+ *   ./loadtest_fleet -n 500 -d 60
+ *
+ * Options:
+ *   -n N     number of robots (default 50)
+ *   -d SECS  test duration (default 30)
+ *   -b SECS  heartbeat interval per robot (default 5)
+ *   -m MS    per-robot message interval in ms, 0 disables (default 1000)
+ *   -r SECS  report interval (default 5)
+ *   -k FILE  keystore for keypair reuse across runs (built on first run;
+ *            subsequent runs skip keygen and provisioning entirely)
+ *   -H HOST  server host (default localhost)
+ *   -p PORT  TCP port (default 5002)
+ *   -P PORT  HTTP port for provisioning (default 8080)
+ */
+
+#include "robomesh.h"
+#include "robomesh_engine.h"
+#include "robomesh_keystore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+static const char *HOST = "localhost";
+static int TCP_PORT = 5002;
+static int HTTP_PORT = 8080;
+
+/* ── Admin helper (calls curl) ─────────────────────────────── */
+
+static char admin_token[2048] = {0};
+
+static int admin_login(void) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd),
+        "curl -s -X POST http://%s:%d/auth/login "
+        "-H 'Content-Type: application/json' "
+        "-d '{\"username\":\"admin\",\"password\":\"password1\"}'",
+        HOST, HTTP_PORT);
+
+    FILE *fp = popen(cmd, "r");
+    if (!fp) return -1;
+
+    char response[4096];
+    size_t n = fread(response, 1, sizeof(response) - 1, fp);
+    response[n] = '\0';
+    pclose(fp);
+
+    char *tok = strstr(response, "\"token\":\"");
+    if (!tok) return -1;
+    tok += 9;
+    char *end = strchr(tok, '"');
+    if (!end) return -1;
+    size_t len = end - tok;
+    if (len >= sizeof(admin_token)) return -1;
+    memcpy(admin_token, tok, len);
+    admin_token[len] = '\0';
+    return 0;
+}
+
+static int provision_robot(const char *uuid, const char *pub_hex) {
+    char cmd[2048];
+    snprintf(cmd, sizeof(cmd),
+        "curl -s -o /dev/null -w '%%{http_code}' -X POST http://%s:%d/provision "
+        "-H 'Content-Type: application/json' "
+        "-H 'Authorization: Bearer %s' "
+        "-d '{\"uuid\":\"%s\",\"public_key\":\"%s\",\"device_type\":\"loadtest\"}'",
+        HOST, HTTP_PORT, admin_token, uuid, pub_hex);
+
+    FILE *fp = popen(cmd, "r");
+    if (!fp) return -1;
+
+    char code[16];
+    size_t n = fread(code, 1, sizeof(code) - 1, fp);
+    code[n] = '\0';
+    pclose(fp);
+
+    return (strncmp(code, "201", 3) == 0) ? 0 : -1;
+}
+
+/* ── Latency histograms ────────────────────────────────────── */
+
+/* Same bucket scheme as robomesh_stats_t: bucket i counts samples
+   below (32 << i) microseconds, last bucket collects the rest. */
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void hist_record(uint64_t *hist, uint64_t us) {
+    int i = 0;
+    while (i < ROBOMESH_STATS_BUCKETS - 1 && us >= (uint64_t)(32u << i))
+        i++;
+    hist[i]++;
+}
+
+/* Upper bound (µs) of the bucket where the cumulative count crosses
+   pct, or 0 if the histogram is empty. */
+static uint64_t hist_percentile_us(const uint64_t *hist, double pct) {
+    uint64_t total = 0;
+    for (int i = 0; i < ROBOMESH_STATS_BUCKETS; i++) total += hist[i];
+    if (total == 0) return 0;
+
+    uint64_t target = (uint64_t)(pct * (double)total + 0.5);
+    if (target == 0) target = 1;
+    uint64_t cum = 0;
+    for (int i = 0; i < ROBOMESH_STATS_BUCKETS; i++) {
+        cum += hist[i];
+        if (cum >= target) return (uint64_t)(32u << i);
+    }
+    return (uint64_t)(32u << (ROBOMESH_STATS_BUCKETS - 1));
+}
+
+static void print_percentiles(const char *label, const uint64_t *hist) {
+    uint64_t total = 0;
+    for (int i = 0; i < ROBOMESH_STATS_BUCKETS; i++) total += hist[i];
+    if (total == 0) {
+        printf("    %-12s (no samples)\n", label);
+        return;
+    }
+    printf("    %-12s p50<%lluus  p95<%lluus  p99<%lluus  (%llu samples)\n",
+           label,
+           (unsigned long long)hist_percentile_us(hist, 0.50),
+           (unsigned long long)hist_percentile_us(hist, 0.95),
+           (unsigned long long)hist_percentile_us(hist, 0.99),
+           (unsigned long long)total);
+}
+
+/* ── Fleet state ───────────────────────────────────────────── */
+
+typedef struct {
+    robomesh_client_t *client;
+    char uuid[64];
+    bool alive;
+} fleet_robot_t;
+
+static void on_engine_message(robomesh_client_t *client, const char *message,
+                               void *user_data) {
+    (void)client;
+    (void)message;
+    (void)user_data;
+    /* Received-message counts come from the per-client stats */
+}
+
+/* Sum every client's counters into *out (histograms included). */
+static void aggregate_stats(fleet_robot_t *fleet, int n, robomesh_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < n; i++) {
+        if (!fleet[i].client) continue;
+        robomesh_stats_t s;
+        if (robomesh_get_stats(fleet[i].client, &s) != ROBOMESH_OK) continue;
+        out->messages_sent += s.messages_sent;
+        out->messages_received += s.messages_received;
+        out->bytes_sent += s.bytes_sent;
+        out->bytes_received += s.bytes_received;
+        out->heartbeats_sent += s.heartbeats_sent;
+        out->heartbeat_failures += s.heartbeat_failures;
+        out->reconnects += s.reconnects;
+        out->auth_failures += s.auth_failures;
+        out->recv_overflows += s.recv_overflows;
+        for (int b = 0; b < ROBOMESH_STATS_BUCKETS; b++) {
+            out->heartbeat_rtt[b] += s.heartbeat_rtt[b];
+            out->send_latency[b] += s.send_latency[b];
+        }
+    }
+}
+
+static void report_window(const robomesh_stats_t *cur,
+                           const robomesh_stats_t *prev,
+                           int window_secs, int alive) {
+    uint64_t beats = cur->heartbeats_sent - prev->heartbeats_sent;
+    uint64_t beat_fails = cur->heartbeat_failures - prev->heartbeat_failures;
+    uint64_t sent = cur->messages_sent - prev->messages_sent;
+    uint64_t reconnects = cur->reconnects - prev->reconnects;
+
+    uint64_t rtt[ROBOMESH_STATS_BUCKETS], lat[ROBOMESH_STATS_BUCKETS];
+    for (int b = 0; b < ROBOMESH_STATS_BUCKETS; b++) {
+        rtt[b] = cur->heartbeat_rtt[b] - prev->heartbeat_rtt[b];
+        lat[b] = cur->send_latency[b] - prev->send_latency[b];
+    }
+
+    printf("  [window %ds] alive=%d  hb=%llu/s (%llu failed)  "
+           "msgs=%llu/s  reconnects=%llu\n",
+           window_secs, alive,
+           (unsigned long long)(beats / (uint64_t)window_secs),
+           (unsigned long long)beat_fails,
+           (unsigned long long)(sent / (uint64_t)window_secs),
+           (unsigned long long)reconnects);
+    print_percentiles("hb rtt", rtt);
+    print_percentiles("send", lat);
+}
+
+/* ── Main ──────────────────────────────────────────────────── */
+
+int main(int argc, char **argv) {
+    int n_robots = 50;
+    int duration_secs = 30;
+    int hb_interval = 5;
+    int msg_interval_ms = 1000;
+    int report_interval = 5;
+    const char *keystore_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:b:m:r:k:H:p:P:h")) != -1) {
+        switch (opt) {
+        case 'n': n_robots = atoi(optarg); break;
+        case 'd': duration_secs = atoi(optarg); break;
+        case 'b': hb_interval = atoi(optarg); break;
+        case 'm': msg_interval_ms = atoi(optarg); break;
+        case 'r': report_interval = atoi(optarg); break;
+        case 'k': keystore_path = optarg; break;
+        case 'H': HOST = optarg; break;
+        case 'p': TCP_PORT = atoi(optarg); break;
+        case 'P': HTTP_PORT = atoi(optarg); break;
+        default:
+            fprintf(stderr,
+                "Usage: %s [-n robots] [-d secs] [-b hb_secs] [-m msg_ms]\n"
+                "          [-r report_secs] [-k keystore] [-H host] [-p tcp] [-P http]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+    if (n_robots <= 0 || duration_secs <= 0 || hb_interval <= 0 ||
+        report_interval <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    printf("Robomesh fleet load test: %d robots, %ds, hb every %ds, "
+           "msg every %dms\n\n",
+           n_robots, duration_secs, hb_interval, msg_interval_ms);
+
+    fleet_robot_t *fleet = calloc((size_t)n_robots, sizeof(*fleet));
+    robomesh_keypair_t *keys = calloc((size_t)n_robots, sizeof(*keys));
+    const char **uuid_ptrs = calloc((size_t)n_robots, sizeof(*uuid_ptrs));
+    if (!fleet || !keys || !uuid_ptrs) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    /* ── Keys: reuse the keystore when possible, else generate,
+       provision, and (with -k) build the store for next time ───── */
+    robomesh_keystore_t *ks =
+        keystore_path ? robomesh_keystore_open(keystore_path) : NULL;
+    bool from_store = ks && robomesh_keystore_count(ks) >= (size_t)n_robots;
+
+    if (from_store) {
+        printf("Loading %d keypairs from %s...\n", n_robots, keystore_path);
+        for (int i = 0; i < n_robots; i++) {
+            robomesh_keystore_get_at(ks, (size_t)i, fleet[i].uuid, &keys[i]);
+        }
+    } else {
+        if (admin_login() < 0) {
+            fprintf(stderr, "Admin login failed — is roboserver running?\n");
+            return 1;
+        }
+        printf("Generating and provisioning %d robots...\n", n_robots);
+        long run_id = (long)time(NULL);
+        for (int i = 0; i < n_robots; i++) {
+            snprintf(fleet[i].uuid, sizeof(fleet[i].uuid),
+                     "loadtest-%ld-%d", run_id, i);
+            if (robomesh_generate_keypair(&keys[i]) != ROBOMESH_OK) {
+                fprintf(stderr, "Key generation failed at robot %d\n", i);
+                return 1;
+            }
+            char pub_hex[65];
+            robomesh_public_key_hex(&keys[i], pub_hex);
+            if (provision_robot(fleet[i].uuid, pub_hex) < 0) {
+                fprintf(stderr, "Provisioning failed for %s\n", fleet[i].uuid);
+                return 1;
+            }
+        }
+        if (keystore_path) {
+            for (int i = 0; i < n_robots; i++)
+                uuid_ptrs[i] = fleet[i].uuid;
+            if (robomesh_keystore_build(keystore_path, uuid_ptrs, keys,
+                                        (size_t)n_robots) == ROBOMESH_OK)
+                printf("Keystore written to %s — next run skips "
+                       "provisioning\n", keystore_path);
+        }
+    }
+    if (ks) robomesh_keystore_close(ks);
+
+    /* ── Auth phase ─────────────────────────────────────────── */
+    robomesh_engine_t *engine = robomesh_engine_create();
+    if (!engine) {
+        fprintf(stderr, "Failed to create engine\n");
+        return 1;
+    }
+
+    uint64_t auth_hist[ROBOMESH_STATS_BUCKETS] = {0};
+    int auth_failed = 0;
+    int alive = 0;
+    uint64_t auth_start = now_us();
+
+    for (int i = 0; i < n_robots; i++) {
+        robomesh_config_t cfg = {
+            .uuid = fleet[i].uuid,
+            .host = HOST,
+            .tcp_port = TCP_PORT,
+            .device_type = "loadtest",
+            .keypair = &keys[i],
+        };
+        fleet[i].client = robomesh_client_create(&cfg);
+        if (!fleet[i].client) {
+            auth_failed++;
+            continue;
+        }
+
+        uint64_t t0 = now_us();
+        if (robomesh_connect(fleet[i].client) != ROBOMESH_OK ||
+            robomesh_authenticate(fleet[i].client) != ROBOMESH_OK) {
+            auth_failed++;
+            continue;
+        }
+        hist_record(auth_hist, now_us() - t0);
+
+        if (robomesh_engine_add(engine, fleet[i].client, hb_interval, 0,
+                                on_engine_message, NULL) != ROBOMESH_OK) {
+            auth_failed++;
+            continue;
+        }
+        fleet[i].alive = true;
+        alive++;
+    }
+
+    double auth_secs = (double)(now_us() - auth_start) / 1e6;
+    printf("\nAuth phase: %d/%d connected in %.1fs (%.0f auths/s), "
+           "%d failed\n", alive, n_robots, auth_secs,
+           auth_secs > 0 ? (double)alive / auth_secs : 0.0, auth_failed);
+    print_percentiles("auth", auth_hist);
+
+    if (alive == 0) {
+        fprintf(stderr, "\nNo robot authenticated — aborting\n");
+        return 1;
+    }
+
+    /* ── Drive phase ────────────────────────────────────────── */
+    if (robomesh_engine_start(engine) != ROBOMESH_OK) {
+        fprintf(stderr, "Failed to start engine\n");
+        return 1;
+    }
+    printf("\nDriving fleet for %ds...\n", duration_secs);
+
+    robomesh_stats_t prev, cur;
+    aggregate_stats(fleet, n_robots, &prev);
+
+    uint64_t end_us = now_us() + (uint64_t)duration_secs * 1000000;
+    uint64_t next_msg_us = now_us();
+    uint64_t next_report_us = now_us() + (uint64_t)report_interval * 1000000;
+    uint64_t tick = 0;
+
+    while (now_us() < end_us) {
+        if (msg_interval_ms > 0 && now_us() >= next_msg_us) {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "{\"loadtest\":true,\"tick\":%llu}",
+                     (unsigned long long)tick++);
+            for (int i = 0; i < n_robots; i++) {
+                if (!fleet[i].alive) continue;
+                if (robomesh_send(fleet[i].client, msg) != ROBOMESH_OK) {
+                    fleet[i].alive = false;
+                    alive--;
+                }
+            }
+            next_msg_us += (uint64_t)msg_interval_ms * 1000;
+        }
+
+        if (now_us() >= next_report_us) {
+            aggregate_stats(fleet, n_robots, &cur);
+            report_window(&cur, &prev, report_interval, alive);
+            prev = cur;
+            next_report_us += (uint64_t)report_interval * 1000000;
+        }
+
+        usleep(10000);
+    }
+
+    /* ── Teardown and totals ────────────────────────────────── */
+    robomesh_engine_stop(engine);
+    aggregate_stats(fleet, n_robots, &cur);
+
+    printf("\nTotals over %ds:\n", duration_secs);
+    printf("    robots alive at end:   %d/%d\n", alive, n_robots);
+    printf("    heartbeats acked:      %llu (%llu failed)\n",
+           (unsigned long long)cur.heartbeats_sent,
+           (unsigned long long)cur.heartbeat_failures);
+    printf("    messages sent:         %llu (%llu KB)\n",
+           (unsigned long long)cur.messages_sent,
+           (unsigned long long)(cur.bytes_sent / 1024));
+    printf("    messages received:     %llu\n",
+           (unsigned long long)cur.messages_received);
+    printf("    reconnects:            %llu\n",
+           (unsigned long long)cur.reconnects);
+    print_percentiles("hb rtt", cur.heartbeat_rtt);
+    print_percentiles("send", cur.send_latency);
+
+    robomesh_engine_destroy(engine);
+    for (int i = 0; i < n_robots; i++) {
+        if (fleet[i].client) {
+            robomesh_disconnect(fleet[i].client);
+            robomesh_client_destroy(fleet[i].client);
+        }
+    }
+    free(fleet);
+    free(keys);
+    free(uuid_ptrs);
+
+    return 0;
+}
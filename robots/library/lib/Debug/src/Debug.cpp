@@ -1 +1,55 @@
-#include "Debug.h"
\ No newline at end of file
+#include "Debug.h"
+
+#if DEBUG_LOG_LEVEL >= 1
+
+// Deferred event ring: fixed-size binary records so DEBUG_EVENT() is a
+// store and an index bump, nothing more
+namespace {
+
+struct DebugEvent {
+    uint32_t ms;
+    uint32_t value;
+    uint8_t id;
+};
+
+const uint8_t EVENT_RING_SIZE = 64;
+DebugEvent eventRing[EVENT_RING_SIZE];
+uint8_t eventHead = 0;   // Oldest undrained event
+uint8_t eventCount = 0;
+uint16_t eventsDropped = 0;
+
+} // namespace
+
+void debugEventRecord(uint8_t id, uint32_t value) {
+    if (eventCount == EVENT_RING_SIZE) {
+        eventsDropped++;
+        return;
+    }
+    DebugEvent& e = eventRing[(uint8_t)((eventHead + eventCount) % EVENT_RING_SIZE)];
+    e.ms = millis();
+    e.value = value;
+    e.id = id;
+    eventCount++;
+}
+
+void debugEventDrain() {
+    while (eventCount > 0) {
+        const DebugEvent& e = eventRing[eventHead];
+        Serial.print('[');
+        Serial.print(e.ms);
+        Serial.print("] event ");
+        Serial.print(e.id);
+        Serial.print(" = ");
+        Serial.println(e.value);
+        eventHead = (uint8_t)((eventHead + 1) % EVENT_RING_SIZE);
+        eventCount--;
+    }
+    if (eventsDropped > 0) {
+        Serial.print("(dropped ");
+        Serial.print(eventsDropped);
+        Serial.println(" events)");
+        eventsDropped = 0;
+    }
+}
+
+#endif // DEBUG_LOG_LEVEL >= 1
@@ -1,9 +1,25 @@
 #ifndef ROBOMESH_DEBUG_H
 #define ROBOMESH_DEBUG_H
 
+// Compile-time log level: 0=off, 1=error, 2=warning, 3=info, 4=verbose.
+// Calls below the configured level compile to nothing — zero code and
+// zero string literals in flash. Set it from the build flags, e.g.
+// -DDEBUG_LOG_LEVEL=2 to keep only errors and warnings. Defining DEBUG
+// without a level keeps the old behavior (everything on).
+#ifndef DEBUG_LOG_LEVEL
 #ifdef DEBUG
+#define DEBUG_LOG_LEVEL 4
+#else
+#define DEBUG_LOG_LEVEL 0
+#endif
+#endif
 
+#if DEBUG_LOG_LEVEL >= 1
 #include <Arduino.h>
+#endif
+
+// Verbose prints (level 4) — the chatty per-I/O output
+#if DEBUG_LOG_LEVEL >= 4
 
 #define DEBUG_PRINTLN(x) Serial.println(x)
 #define DEBUG_PRINT(x) Serial.print(x)
@@ -37,9 +53,6 @@
         obj.printTo(Serial); \
         Serial.println(); \
     }
-#define DEBUG_PRINT_ERROR(x) Serial.print("Error: "); Serial.println(x)
-#define DEBUG_PRINT_WARNING(x) Serial.print("Warning: "); Serial.println(x)
-#define DEBUG_PRINT_INFO(x) Serial.print("Info: "); Serial.println(x)
 
 #else
 
@@ -54,10 +67,46 @@
 #define DEBUG_PRINT_BUFFER(buf, len)
 #define DEBUG_PRINT_ARRAY(arr, len)
 #define DEBUG_PRINT_OBJECT(obj)
-#define DEBUG_PRINT_ERROR(x)
-#define DEBUG_PRINT_WARNING(x)
+
+#endif // DEBUG_LOG_LEVEL >= 4
+
+#if DEBUG_LOG_LEVEL >= 3
+#define DEBUG_PRINT_INFO(x) Serial.print("Info: "); Serial.println(x)
+#else
 #define DEBUG_PRINT_INFO(x)
+#endif
+
+#if DEBUG_LOG_LEVEL >= 2
+#define DEBUG_PRINT_WARNING(x) Serial.print("Warning: "); Serial.println(x)
+#else
+#define DEBUG_PRINT_WARNING(x)
+#endif
+
+#if DEBUG_LOG_LEVEL >= 1
+#define DEBUG_PRINT_ERROR(x) Serial.print("Error: "); Serial.println(x)
+#else
+#define DEBUG_PRINT_ERROR(x)
+#endif
+
+// Deferred logging: DEBUG_EVENT() records a fixed-size binary event
+// (id, value, millis) into a RAM ring buffer in a few cycles — no
+// serial I/O in the hot path, where a blocking 115200-baud write costs
+// milliseconds. Call DEBUG_DRAIN() outside the control loop to print
+// and empty the buffer; events recorded while the buffer is full are
+// dropped and reported by the next drain.
+#if DEBUG_LOG_LEVEL >= 1
+
+void debugEventRecord(uint8_t id, uint32_t value);
+void debugEventDrain();
+
+#define DEBUG_EVENT(id, value) debugEventRecord((id), (uint32_t)(value))
+#define DEBUG_DRAIN() debugEventDrain()
+
+#else
+
+#define DEBUG_EVENT(id, value)
+#define DEBUG_DRAIN()
 
-#endif // DEBUG
+#endif // DEBUG_LOG_LEVEL >= 1
 
-#endif // ROBOMESH_DEBUG_H
\ No newline at end of file
+#endif // ROBOMESH_DEBUG_H
@@ -1,4 +1,8 @@
 #include <RobomeshWiFi.h>
+#include <Ed25519.h>
+
+// Shared nibble lookup for hex encoding (signature + payload builders)
+static const char HEX_CHARS[] = "0123456789abcdef";
 
 RobomeshWiFi::RobomeshWiFi(int tcpPort = 80) : _connected(false), tcpPort(tcpPort) {
     // Constructor
@@ -33,6 +37,91 @@ bool RobomeshWiFi::begin(const char* ssid, const char* password) {
     }
 }
 
+bool RobomeshWiFi::beginAsync(const char* ssid, const char* password) {
+    if (ssid == nullptr || password == nullptr) {
+        return false;
+    }
+
+    // Keep our own copies so poll() can re-associate after drops
+    strncpy(_ssid, ssid, sizeof(_ssid) - 1);
+    _ssid[sizeof(_ssid) - 1] = '\0';
+    strncpy(_password, password, sizeof(_password) - 1);
+    _password[sizeof(_password) - 1] = '\0';
+
+    DEBUG_PRINT("Connecting to WiFi (async): ");
+    DEBUG_PRINTLN(_ssid);
+
+    WiFi.begin(_ssid, _password);
+    _attemptStartMs = millis();
+    setConnState(WIFI_STATE_CONNECTING);
+    return true;
+}
+
+WiFiConnState RobomeshWiFi::poll() {
+    // Push out buffered sends whose deadline has passed
+    if (_sendBufLen > 0 && millis() - _firstBufferedMs >= _maxBufferDelayMs) {
+        tcpFlush();
+    }
+
+    switch (_connState) {
+        case WIFI_STATE_IDLE:
+            break;
+
+        case WIFI_STATE_CONNECTING:
+            if (WiFi.status() == WL_CONNECTED) {
+                _connected = true;
+                DEBUG_PRINTLN("WiFi connected!");
+                DEBUG_PRINT("IP address: ");
+                DEBUG_PRINTLN(WiFi.localIP());
+                setConnState(WIFI_STATE_CONNECTED);
+            } else if (millis() - _attemptStartMs >= CONNECT_TIMEOUT_MS) {
+                DEBUG_PRINTLN("WiFi connection attempt timed out");
+                _attemptStartMs = millis();
+                setConnState(WIFI_STATE_FAILED);
+            }
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (WiFi.status() != WL_CONNECTED) {
+                // Association lost — start reconnecting right away
+                _connected = false;
+                DEBUG_PRINTLN("WiFi association lost, reconnecting");
+                WiFi.begin(_ssid, _password);
+                _attemptStartMs = millis();
+                setConnState(WIFI_STATE_CONNECTING);
+            }
+            break;
+
+        case WIFI_STATE_FAILED:
+            if (millis() - _attemptStartMs >= RETRY_DELAY_MS) {
+                DEBUG_PRINTLN("Retrying WiFi connection");
+                WiFi.begin(_ssid, _password);
+                _attemptStartMs = millis();
+                setConnState(WIFI_STATE_CONNECTING);
+            }
+            break;
+    }
+    return _connState;
+}
+
+WiFiConnState RobomeshWiFi::getConnectionState() {
+    return _connState;
+}
+
+void RobomeshWiFi::onConnectionState(WiFiStateCallback callback) {
+    _stateCallback = callback;
+}
+
+void RobomeshWiFi::setConnState(WiFiConnState state) {
+    if (state == _connState) {
+        return;
+    }
+    _connState = state;
+    if (_stateCallback != nullptr) {
+        _stateCallback(state);
+    }
+}
+
 bool RobomeshWiFi::isConnected() {
     return WiFi.status() == WL_CONNECTED && _connected;
 }
@@ -67,31 +156,169 @@ bool RobomeshWiFi::tcpSend(const uint8_t* data, size_t length) {
         DEBUG_PRINTLN("Cannot send data: not connected to WiFi or TCP");
         return false;
     }
-    
+
+    if (_sendBuffering) {
+        return appendToSendBuffer(data, length);
+    }
+    return tcpWriteRaw(data, length);
+}
+
+bool RobomeshWiFi::tcpSend(const String& data) {
+    return tcpSend((const uint8_t*)data.c_str(), data.length());
+}
+
+bool RobomeshWiFi::tcpWriteRaw(const uint8_t* data, size_t length) {
     size_t bytesSent = client.write(data, length);
     DEBUG_PRINT("Sent ");
     DEBUG_PRINT_DEC(bytesSent);
     DEBUG_PRINT(" of ");
     DEBUG_PRINT_DEC(length);
     DEBUG_PRINTLN(" bytes");
-    
+
     return bytesSent == length;  // Return true only if all bytes were sent
 }
 
-bool RobomeshWiFi::tcpSend(const String& data) {
+bool RobomeshWiFi::setRobotIdentity(const char* uuid,
+                                    const uint8_t privateKey[32],
+                                    const uint8_t publicKey[32]) {
+    if (uuid == nullptr || privateKey == nullptr || publicKey == nullptr) {
+        return false;
+    }
+    size_t uuidLen = strlen(uuid);
+    if (uuidLen == 0 || uuidLen > 40) {
+        return false;
+    }
+
+    int n = snprintf(_hbPrefix, sizeof(_hbPrefix), "HEARTBEAT %s ", uuid);
+    _hbPrefixLen = (size_t)n;
+    memcpy(_hbPrivateKey, privateKey, 32);
+    memcpy(_hbPublicKey, publicKey, 32);
+    _heartbeatSeq = 0;
+    _identitySet = true;
+    return true;
+}
+
+bool RobomeshWiFi::tcpSendHeartbeat() {
+    if (!_identitySet) {
+        DEBUG_PRINTLN("Cannot send heartbeat: identity not set");
+        return false;
+    }
     if (!isConnected() || !client.connected()) {
-        DEBUG_PRINTLN("Cannot send data: not connected to WiFi or TCP");
+        DEBUG_PRINTLN("Cannot send heartbeat: not connected to WiFi or TCP");
         return false;
     }
-    
-    size_t bytesSent = client.print(data);
-    DEBUG_PRINT("Sent ");
-    DEBUG_PRINT_DEC(bytesSent);
-    DEBUG_PRINT(" of ");
-    DEBUG_PRINT_DEC(data.length());
-    DEBUG_PRINTLN(" bytes");
 
-    return bytesSent == data.length();
+    // Payload: {"seq":N} — the sequence lives in a member, so only the
+    // digits reformat each beat
+    char payload[24];
+    int payloadLen = snprintf(payload, sizeof(payload), "{\"seq\":%lu}",
+                              (unsigned long)++_heartbeatSeq);
+
+    uint8_t signature[64];
+    Ed25519::sign(signature, _hbPrivateKey, _hbPublicKey, payload, payloadLen);
+
+    // Assemble "HEARTBEAT <uuid> <payload> <sigHex>\n" in one static
+    // buffer: prefix(<=47) + payload(<=23) + sig(128) + separators
+    char line[208];
+    size_t pos = _hbPrefixLen;
+    memcpy(line, _hbPrefix, _hbPrefixLen);
+    memcpy(line + pos, payload, payloadLen);
+    pos += payloadLen;
+    line[pos++] = ' ';
+    for (int i = 0; i < 64; i++) {
+        line[pos++] = HEX_CHARS[signature[i] >> 4];
+        line[pos++] = HEX_CHARS[signature[i] & 0x0F];
+    }
+    line[pos++] = '\n';
+
+    if (_sendBufLen > 0) {
+        tcpFlush();  // Keep ordering with any buffered telemetry
+    }
+    return tcpWriteRaw((const uint8_t*)line, pos);
+}
+
+void RobomeshWiFi::setSendBuffering(bool enabled, unsigned long maxDelayMs) {
+    if (!enabled && _sendBufLen > 0) {
+        tcpFlush();  // Don't strand buffered data when turning it off
+    }
+    _sendBuffering = enabled;
+    _maxBufferDelayMs = maxDelayMs;
+}
+
+bool RobomeshWiFi::tcpFlush() {
+    if (_sendBufLen == 0) {
+        return true;
+    }
+    if (!isConnected() || !client.connected()) {
+        DEBUG_PRINTLN("Cannot flush: not connected to WiFi or TCP");
+        _sendBufLen = 0;
+        return false;
+    }
+    bool ok = tcpWriteRaw(_sendBuf, _sendBufLen);
+    _sendBufLen = 0;
+    return ok;
+}
+
+bool RobomeshWiFi::appendToSendBuffer(const uint8_t* data, size_t length) {
+    // Oversized payloads bypass the buffer (after flushing to keep order)
+    if (length > SEND_BUFFER_SIZE) {
+        if (!tcpFlush()) {
+            return false;
+        }
+        return tcpWriteRaw(data, length);
+    }
+
+    // Flush when the new data wouldn't fit, or the deadline passed
+    if (_sendBufLen + length > SEND_BUFFER_SIZE ||
+        (_sendBufLen > 0 && millis() - _firstBufferedMs >= _maxBufferDelayMs)) {
+        if (!tcpFlush()) {
+            return false;
+        }
+    }
+
+    if (_sendBufLen == 0) {
+        _firstBufferedMs = millis();
+    }
+    memcpy(_sendBuf + _sendBufLen, data, length);
+    _sendBufLen += length;
+    return true;
+}
+
+bool RobomeshWiFi::writeBatch(const uint8_t** chunks, const size_t* lengths, int count) {
+    if (chunks == nullptr || lengths == nullptr || count <= 0) {
+        return false;
+    }
+    if (!isConnected() || !client.connected()) {
+        DEBUG_PRINTLN("Cannot send batch: not connected to WiFi or TCP");
+        return false;
+    }
+
+    if (_sendBuffering) {
+        for (int i = 0; i < count; i++) {
+            if (!appendToSendBuffer(chunks[i], lengths[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Unbuffered: coalesce through the send buffer so the whole batch
+    // still goes out as few segments as possible
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        if (lengths[i] > SEND_BUFFER_SIZE) {
+            ok = tcpFlush() && ok;
+            ok = tcpWriteRaw(chunks[i], lengths[i]) && ok;
+            continue;
+        }
+        if (_sendBufLen + lengths[i] > SEND_BUFFER_SIZE) {
+            ok = tcpFlush() && ok;
+        }
+        memcpy(_sendBuf + _sendBufLen, chunks[i], lengths[i]);
+        _sendBufLen += lengths[i];
+    }
+    ok = tcpFlush() && ok;
+    return ok;
 }
 
 size_t RobomeshWiFi::tcpReceive(uint8_t* buffer, size_t maxLength) {
@@ -5,6 +5,17 @@
 #include <WiFiS3.h>
 #include <Debug.h>
 
+// Connection state reported by the async WiFi API
+enum WiFiConnState {
+    WIFI_STATE_IDLE,        // beginAsync() not called yet
+    WIFI_STATE_CONNECTING,  // Association in progress
+    WIFI_STATE_CONNECTED,   // Associated with an IP
+    WIFI_STATE_FAILED       // Last attempt timed out; retrying soon
+};
+
+// Invoked from poll() whenever the connection state changes
+typedef void (*WiFiStateCallback)(WiFiConnState state);
+
 class RobomeshWiFi {
 public:
     RobomeshWiFi(int tcpPort = 80);
@@ -14,6 +25,15 @@ public:
     bool isConnected();
     void disconnect();
 
+    // Async WiFi connection: beginAsync() starts association and returns
+    // immediately; call poll() from loop() to advance the state machine.
+    // The sketch keeps running at full rate while WiFi associates, and
+    // lost associations are re-established automatically.
+    bool beginAsync(const char* ssid, const char* password);
+    WiFiConnState poll();
+    WiFiConnState getConnectionState();
+    void onConnectionState(WiFiStateCallback callback);
+
     // Network information
     String getIPAddress();
     int getRSSI();
@@ -25,7 +45,25 @@ public:
     bool tcpConnect(const char* host, int port);       // Establish TCP connection
     void tcpDisconnect();                              // Close TCP connection gracefully
     bool isTcpConnected();                             // Check if TCP session is active
-    void tcpSendHeartbeat();                           // TODO: Send a heartbeat message to keep the connection alive
+
+    // Signed heartbeat protocol (same wire format as the C SDK):
+    // setRobotIdentity() takes the robot's UUID and raw Ed25519 keypair
+    // (32-byte seed + 32-byte public key); tcpSendHeartbeat() then emits
+    // one "HEARTBEAT <uuid> {\"seq\":N} <sig>" line per call, signing
+    // with static buffers only — no String churn, no heap.
+    bool setRobotIdentity(const char* uuid,
+                          const uint8_t privateKey[32],
+                          const uint8_t publicKey[32]);
+    bool tcpSendHeartbeat();
+
+    // Buffered sends: with buffering enabled, tcpSend() appends to a
+    // fixed buffer and one coalesced TCP segment goes out on tcpFlush(),
+    // when the buffer fills, or when maxDelayMs has passed since the
+    // first buffered byte (checked from tcpSend() and poll()). Cuts the
+    // per-write stack overhead when emitting many small telemetry fields.
+    void setSendBuffering(bool enabled, unsigned long maxDelayMs = 50);
+    bool tcpFlush();                                   // Force out buffered data
+    bool writeBatch(const uint8_t** chunks, const size_t* lengths, int count);
 
     void setAuthorizationKey(const char* key);
     
@@ -39,6 +77,35 @@ private:
     int tcpPort;
     bool _connected;
     char authorizationKey[33]; // 32 characters + null terminator for API key
+
+    // Signed heartbeat state: the line prefix never changes, so it is
+    // preserialized once and only the sequence digits reformat per beat
+    char _hbPrefix[64];        // "HEARTBEAT <uuid> "
+    size_t _hbPrefixLen = 0;
+    uint8_t _hbPrivateKey[32];
+    uint8_t _hbPublicKey[32];
+    bool _identitySet = false;
+    uint32_t _heartbeatSeq = 0;
+
+    // Buffered send path
+    bool tcpWriteRaw(const uint8_t* data, size_t length);
+    bool appendToSendBuffer(const uint8_t* data, size_t length);
+    static const size_t SEND_BUFFER_SIZE = 1024;
+    uint8_t _sendBuf[SEND_BUFFER_SIZE];
+    size_t _sendBufLen = 0;
+    bool _sendBuffering = false;
+    unsigned long _maxBufferDelayMs = 50;
+    unsigned long _firstBufferedMs = 0;
+
+    // Async connection state machine (advanced from poll())
+    void setConnState(WiFiConnState state);
+    WiFiConnState _connState = WIFI_STATE_IDLE;
+    WiFiStateCallback _stateCallback = nullptr;
+    char _ssid[33];            // Max SSID length is 32
+    char _password[64];
+    unsigned long _attemptStartMs = 0;
+    static const unsigned long CONNECT_TIMEOUT_MS = 10000;  // Matches begin()
+    static const unsigned long RETRY_DELAY_MS = 5000;
 };
 
 #endif // ROBOMESH_ARDUINO_R4_WIFI_H